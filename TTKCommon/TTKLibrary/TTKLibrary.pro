@@ -68,6 +68,7 @@ HEADERS += \
     $$PWD/ttkabstracttablewidget.h \
     $$PWD/ttkabstractthread.h \
     $$PWD/ttkabstractxml.h \
+    $$PWD/ttkabstractstreamxml.h \
     $$PWD/ttkany.h \
     $$PWD/ttkclickedgroup.h \
     $$PWD/ttkclickedlabel.h \
@@ -106,6 +107,7 @@ SOURCES += \
     $$PWD/ttkabstracttablewidget.cpp \
     $$PWD/ttkabstractthread.cpp \
     $$PWD/ttkabstractxml.cpp \
+    $$PWD/ttkabstractstreamxml.cpp \
     $$PWD/ttkany.cpp \
     $$PWD/ttkclickedgroup.cpp \
     $$PWD/ttkclickedlabel.cpp \
@@ -0,0 +1,181 @@
+#include "ttkabstractstreamxml.h"
+
+TTKAbstractStreamXml::TTKAbstractStreamXml()
+    : m_file(nullptr),
+      m_reader(nullptr),
+      m_writer(nullptr)
+{
+
+}
+
+TTKAbstractStreamXml::~TTKAbstractStreamXml()
+{
+    clear();
+}
+
+bool TTKAbstractStreamXml::load(const QString &name)
+{
+    clear();
+
+    m_file = new QFile(name);
+    if(!m_file->open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        return false;
+    }
+
+    m_writer = new QXmlStreamWriter(m_file);
+    m_writer->setAutoFormatting(true);
+    m_writer->setAutoFormattingIndent(4);
+    return true;
+}
+
+bool TTKAbstractStreamXml::fromFile(const QString &name)
+{
+    clear();
+
+    m_file = new QFile(name);
+    if(!m_file->open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return false;
+    }
+
+    m_reader = new QXmlStreamReader(m_file);
+    if(!m_reader->readNextStartElement())
+    {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool TTKAbstractStreamXml::fromByteArray(const QByteArray &data)
+{
+    clear();
+
+    m_reader = new QXmlStreamReader(data);
+    if(!m_reader->readNextStartElement())
+    {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool TTKAbstractStreamXml::reset()
+{
+    if(!m_file)
+    {
+        return false;
+    }
+
+    const QString name(m_file->fileName());
+    return load(name);
+}
+
+bool TTKAbstractStreamXml::readNextElement() const
+{
+    if(!m_reader)
+    {
+        return false;
+    }
+
+    while(!m_reader->atEnd())
+    {
+        if(m_reader->readNext() == QXmlStreamReader::StartElement)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString TTKAbstractStreamXml::nodeName() const
+{
+    return m_reader ? m_reader->name().toString() : QString();
+}
+
+QString TTKAbstractStreamXml::readAttribute(const QString &name) const
+{
+    return m_reader ? m_reader->attributes().value(name).toString() : QString();
+}
+
+QString TTKAbstractStreamXml::readText() const
+{
+    return m_reader ? m_reader->readElementText(QXmlStreamReader::SkipChildElements) : QString();
+}
+
+bool TTKAbstractStreamXml::hasError() const
+{
+    return !m_reader || m_reader->hasError();
+}
+
+void TTKAbstractStreamXml::writeStartDocument(const QString &root) const
+{
+    if(!m_writer)
+    {
+        return;
+    }
+
+    m_writer->writeStartDocument();
+    m_writer->writeStartElement(root);
+}
+
+bool TTKAbstractStreamXml::writeEndDocument() const
+{
+    if(!m_writer)
+    {
+        return false;
+    }
+
+    m_writer->writeEndElement();
+    m_writer->writeEndDocument();
+    return m_file->flush() && !m_writer->hasError() && m_file->error() == QFile::NoError;
+}
+
+void TTKAbstractStreamXml::writeStartElement(const QString &node, const TTKXmlAttrList &attrs) const
+{
+    if(!m_writer)
+    {
+        return;
+    }
+
+    m_writer->writeStartElement(node);
+    for(const TTKXmlAttr &attr : qAsConst(attrs))
+    {
+        m_writer->writeAttribute(attr.m_key, attr.m_value.toString());
+    }
+}
+
+void TTKAbstractStreamXml::writeEndElement() const
+{
+    if(m_writer)
+    {
+        m_writer->writeEndElement();
+    }
+}
+
+void TTKAbstractStreamXml::writeElement(const QString &node, const TTKXmlAttrList &attrs, const QString &text) const
+{
+    if(!m_writer)
+    {
+        return;
+    }
+
+    writeStartElement(node, attrs);
+    if(!text.isEmpty())
+    {
+        m_writer->writeCharacters(text);
+    }
+    m_writer->writeEndElement();
+}
+
+void TTKAbstractStreamXml::clear()
+{
+    delete m_reader;
+    delete m_writer;
+    delete m_file;
+
+    m_reader = nullptr;
+    m_writer = nullptr;
+    m_file = nullptr;
+}
@@ -0,0 +1,117 @@
+#ifndef TTKABSTRACTSTREAMXML_H
+#define TTKABSTRACTSTREAMXML_H
+
+/***************************************************************************
+ * This file is part of the TTK Library Module project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include "ttkabstractxml.h"
+
+/*! @brief The class of the ttk stream xml interface.
+ * Read and write xml by pull parser and stream writer without building the document tree,
+ * memory keeps constant for large files.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT TTKAbstractStreamXml
+{
+    TTK_DECLARE_MODULE(TTKAbstractStreamXml)
+public:
+    /*!
+     * Object constructor.
+     */
+    TTKAbstractStreamXml();
+    /*!
+     * Object destructor.
+     */
+    virtual ~TTKAbstractStreamXml();
+
+    /*!
+     * Init writer by given name.
+     */
+    bool load(const QString &name);
+    /*!
+     * Init reader by given name.
+     */
+    bool fromFile(const QString &name);
+    /*!
+     * Init reader by byteArray.
+     */
+    bool fromByteArray(const QByteArray &data);
+    /*!
+     * Reset file by current name, truncate and reopen it for writing.
+     */
+    bool reset();
+
+protected:
+    /*!
+     * Read to next start element, return false when reach end or error.
+     */
+    bool readNextElement() const;
+    /*!
+     * Get current element name.
+     */
+    QString nodeName() const;
+    /*!
+     * Read current element attribute by name.
+     */
+    QString readAttribute(const QString &name) const;
+    /*!
+     * Read current element text, reader moves to the element end.
+     */
+    QString readText() const;
+    /*!
+     * Check reader has error or not.
+     */
+    bool hasError() const;
+
+    /*!
+     * Write document start and root element.
+     */
+    void writeStartDocument(const QString &root) const;
+    /*!
+     * Write root element and document end, return false when writer or file has error.
+     */
+    bool writeEndDocument() const;
+    /*!
+     * Write element start by node name and attributes.
+     */
+    void writeStartElement(const QString &node, const TTKXmlAttrList &attrs = {}) const;
+    /*!
+     * Write element end.
+     */
+    void writeEndElement() const;
+    /*!
+     * Write whole element by node name attributes and text.
+     */
+    void writeElement(const QString &node, const TTKXmlAttrList &attrs, const QString &text = {}) const;
+
+    QFile *m_file;
+    QXmlStreamReader *m_reader;
+    QXmlStreamWriter *m_writer;
+
+private:
+    /*!
+     * Reset all stream data.
+     */
+    void clear();
+
+};
+
+#endif // TTKABSTRACTSTREAMXML_H
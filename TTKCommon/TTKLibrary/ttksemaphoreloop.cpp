@@ -24,6 +24,14 @@ void TTKSemaphoreLoop::exit()
     return QEventLoop::exit();
 }
 
+void TTKSemaphoreLoop::restart()
+{
+    if(m_timer.isActive())
+    {
+        m_timer.start();
+    }
+}
+
 int TTKSemaphoreLoop::exec(ProcessEventsFlags flags)
 {
     m_timer.start();
@@ -54,6 +54,10 @@ public Q_SLOTS:
      * Event loop exit.
      */
     void exit();
+    /*!
+     * Restart the time out timer while the loop is running.
+     */
+    void restart();
 
 private:
     QTimer m_timer;
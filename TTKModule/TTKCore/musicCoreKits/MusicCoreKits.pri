@@ -32,6 +32,10 @@ HEADERS += \
     $$PWD/musiccoremplayer.h \
     $$PWD/musicsong.h \
     $$PWD/musicsongmeta.h \
+    $$PWD/musicsongmetaindex.h \
+    $$PWD/musicreplaygainindex.h \
+    $$PWD/musicsonghashindex.h \
+    $$PWD/musicsongattributethread.h \
     $$PWD/musicbackgroundmanager.h \
     $$PWD/musiccategoryconfigmanager.h  \
     $$PWD/musicplaylistmanager.h \
@@ -52,8 +56,13 @@ SOURCES += \
     $$PWD/musicplatformmanager.cpp \
     $$PWD/musiccoremplayer.cpp \
     $$PWD/musicsingleton.cpp \
+    $$PWD/musicsettingmanager.cpp \
     $$PWD/musicsong.cpp \
     $$PWD/musicsongmeta.cpp \
+    $$PWD/musicsongmetaindex.cpp \
+    $$PWD/musicreplaygainindex.cpp \
+    $$PWD/musicsonghashindex.cpp \
+    $$PWD/musicsongattributethread.cpp \
     $$PWD/musicbackgroundmanager.cpp \
     $$PWD/musiccategoryconfigmanager.cpp \
     $$PWD/musicplaylistmanager.cpp \
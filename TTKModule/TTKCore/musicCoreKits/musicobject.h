@@ -36,6 +36,7 @@
 #define XML_FILE_SUFFIX          "xml"
 // playlist ext
 #define TPL_FILE_SUFFIX          "tkpl"
+#define TBL_FILE_SUFFIX          "tkbl"
 #define M3U_FILE_SUFFIX          "m3u"
 #define M3U8_FILE_SUFFIX         "m3u8"
 #define PLS_FILE_SUFFIX          "pls"
@@ -66,6 +67,7 @@
 #define KRC_FILE                 TTK_STR_CAT(TTK_DOT, KRC_FILE_SUFFIX)
 #define MP3_FILE                 TTK_STR_CAT(TTK_DOT, MP3_FILE_SUFFIX)
 #define TPL_FILE                 TTK_STR_CAT(TTK_DOT, TPL_FILE_SUFFIX)
+#define TBL_FILE                 TTK_STR_CAT(TTK_DOT, TBL_FILE_SUFFIX)
 #define XML_FILE                 TTK_STR_CAT(TTK_DOT, XML_FILE_SUFFIX)
 // file ext
 #define MP3_FILE                 TTK_STR_CAT(TTK_DOT, MP3_FILE_SUFFIX)
@@ -110,6 +112,7 @@
 
 #define COFIG_PATH               TTK_STR_CAT("config", XML_FILE)
 #define PLAYLIST_PATH            TTK_STR_CAT("playlist", TPL_FILE)
+#define PLAYLIST_BINARY_PATH     TTK_STR_CAT("playlist", TBL_FILE)
 #define NORMAL_DOWN_PATH         TTK_STR_CAT("download", TKF_FILE)
 #define CLOUD_DOWN_PATH          TTK_STR_CAT("cdownload", TKF_FILE)
 #define CLOUD_UP_PATH            TTK_STR_CAT("cupload", TKF_FILE)
@@ -134,6 +137,7 @@
 //
 #define COFIG_PATH_FULL          APPDATA_DIR_FULL + COFIG_PATH
 #define PLAYLIST_PATH_FULL       APPDATA_DIR_FULL + PLAYLIST_PATH
+#define PLAYLIST_BINARY_PATH_FULL APPDATA_DIR_FULL + PLAYLIST_BINARY_PATH
 #define NORMAL_DOWN_PATH_FULL    APPDATA_DIR_FULL + NORMAL_DOWN_PATH
 #define CLOUD_DOWN_PATH_FULL     APPDATA_DIR_FULL + CLOUD_DOWN_PATH
 #define CLOUD_UP_PATH_FULL       APPDATA_DIR_FULL + CLOUD_UP_PATH
@@ -2,9 +2,40 @@
 #include "musicplaylist.h"
 #include "musicsettingmanager.h"
 #include "musicconnectionpool.h"
+#include "musicreplaygainindex.h"
 
 #include <qmath.h>
 #include <qmmp/soundcore.h>
+#include <qmmp/qmmpsettings.h>
+
+#define REPLAYGAIN_DEFAULT_PATH  APPCACHE_DIR_FULL + "replaygaindefault"
+
+/// qmmp saves replay gain settings, so user default gain is kept aside until it is restored
+static void saveDefaultGain(double gain)
+{
+    QDir().mkpath(APPCACHE_DIR_FULL);
+
+    QFile file(REPLAYGAIN_DEFAULT_PATH);
+    if(file.open(QIODevice::WriteOnly))
+    {
+        file.write(QByteArray::number(gain));
+        file.close();
+    }
+}
+
+static bool readDefaultGain(double &gain)
+{
+    QFile file(REPLAYGAIN_DEFAULT_PATH);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    bool ok = false;
+    gain = file.readAll().toDouble(&ok);
+    file.close();
+    return ok;
+}
 
 MusicPlayer::MusicPlayer(QObject *parent)
     : QObject(parent),
@@ -12,15 +43,36 @@ MusicPlayer::MusicPlayer(QObject *parent)
       m_state(TTK::PlayState::Stopped),
       m_enhance(Enhance::Off),
       m_duration(0),
-      m_durationTimes(0),
+      m_position(-1),
+      m_granularity(TTK_DN_S2MS),
+      m_effectSecond(-1),
+      m_preroll(true),
+      m_gapPending(false),
+      m_finishPending(false),
+      m_trackEndTime(-1),
+      m_trackGap(-1),
+      m_gainOverride(false),
+      m_defaultGain(0),
       m_volumeMusic3D(0),
       m_posOnCircle(0)
 {
     m_core = new SoundCore(this);
     setEnabledEffect(false);
 
-    m_timer.setInterval(TTK_DN_S2MS);
-    connect(&m_timer, SIGNAL(timeout()), SLOT(update()));
+    double gain = 0;
+    if(readDefaultGain(gain))
+    {
+        ///last run quit while analyzed gain was applied, restore user default gain
+        QmmpSettings *settings = QmmpSettings::instance();
+        settings->setReplayGainSettings(settings->replayGainMode(), settings->replayGainPreamp(), gain, settings->replayGainPreventClipping());
+        QFile::remove(REPLAYGAIN_DEFAULT_PATH);
+    }
+
+    connect(m_core, SIGNAL(elapsedChanged(qint64)), SLOT(elapsedChanged(qint64)));
+    connect(m_core, SIGNAL(stateChanged(Qmmp::State)), SLOT(updateState()));
+    connect(m_core, SIGNAL(nextTrackRequest()), SLOT(prepareNextTrack()));
+    connect(m_core, SIGNAL(trackInfoChanged()), SLOT(switchNextTrack()));
+    connect(m_core, SIGNAL(finished()), SLOT(trackFinished()));
 
     G_CONNECTION_PTR->setValue(className(), this);
 }
@@ -28,7 +80,7 @@ MusicPlayer::MusicPlayer(QObject *parent)
 MusicPlayer::~MusicPlayer()
 {
     m_core->stop();
-    m_timer.stop();
+    applyReplayGain({});
     delete m_core;
 }
 
@@ -113,6 +165,31 @@ MusicPlayer::Enhance MusicPlayer::enhanced() const
     return m_enhance;
 }
 
+void MusicPlayer::setPrerollEnabled(bool enabled)
+{
+    m_preroll = enabled;
+}
+
+bool MusicPlayer::isPrerollEnabled() const
+{
+    return m_preroll;
+}
+
+void MusicPlayer::setPositionGranularity(int msec)
+{
+    m_granularity = qMax(1, msec);
+}
+
+int MusicPlayer::positionGranularity() const
+{
+    return m_granularity;
+}
+
+qint64 MusicPlayer::lastTrackGap() const
+{
+    return m_trackGap;
+}
+
 void MusicPlayer::play()
 {
     if(m_playlist->isEmpty())
@@ -128,11 +205,14 @@ void MusicPlayer::play()
     {
         ///When the pause time for recovery
         m_core->pause();
-        update();
+        Q_EMIT positionChanged(position());
         return;
     }
 
+    m_nextMedia.clear();
+    m_finishPending = false;
     m_currentMedia = m_playlist->currentMediaPath();
+    applyReplayGain(m_currentMedia);
     ///The current playback path
     if(!m_core->play(m_currentMedia))
     {
@@ -140,9 +220,9 @@ void MusicPlayer::play()
         return;
     }
 
-    m_timer.start();
-    m_durationTimes = 0;
-    generateDuration();
+    m_duration = 0;
+    m_position = 0;
+    updateDuration();
     Q_EMIT positionChanged(0);
 }
 
@@ -160,7 +240,9 @@ void MusicPlayer::stop()
     if(m_state != TTK::PlayState::Stopped)
     {
         m_core->stop();
-        m_timer.stop();
+        m_nextMedia.clear();
+        m_gapPending = false;
+        m_finishPending = false;
         setCurrentPlayState(TTK::PlayState::Stopped);
     }
 }
@@ -211,56 +293,165 @@ void MusicPlayer::setEqualizerConfig()
     }
 }
 
-void MusicPlayer::update()
+void MusicPlayer::elapsedChanged(qint64 time)
 {
-    Q_EMIT positionChanged(position());
+    if(m_state != TTK::PlayState::Playing)
+    {
+        return;
+    }
+
+    ///only notify when position moved over the granularity, or moved back by seek
+    if(m_position < 0 || time < m_position || time - m_position >= m_granularity)
+    {
+        m_position = time;
+        Q_EMIT positionChanged(time);
+    }
 
-    if(m_enhance == Enhance::M3D && !isMuted())
+    if(m_duration <= 0)
+    {
+        updateDuration();
+    }
+
+    if(m_duration > 0)
+    {
+        ///expected wall clock time of current track end
+        m_trackEndTime = QDateTime::currentMSecsSinceEpoch() + qMax(m_duration - time, qint64(0));
+    }
+
+    const qint64 second = time / TTK_DN_S2MS;
+    if(m_enhance == Enhance::M3D && !isMuted() && second != m_effectSecond)
     {
         ///3D music settings
+        m_effectSecond = second;
         setEnabledEffect(false);
         m_posOnCircle += 0.5f;
         m_core->setVolume(fabs(TTK_RN_MAX * cosf(m_posOnCircle)), fabs(TTK_RN_MAX * sinf(m_posOnCircle * 0.5f)));
     }
+}
 
+void MusicPlayer::updateState()
+{
     const Qmmp::State state = m_core->state();
-    if(state == Qmmp::NormalError || state == Qmmp::FatalError)
+    if(state == Qmmp::Playing)
+    {
+        if(m_gapPending)
+        {
+            setTrackGap();
+        }
+        updateDuration();
+    }
+    else if(state == Qmmp::NormalError || state == Qmmp::FatalError)
     {
-        m_timer.stop();
+        m_finishPending = false;
         setStopState();
     }
-    else if(state == Qmmp::Stopped)
+    else if(state == Qmmp::Stopped && m_finishPending)
     {
-        m_timer.stop();
-        if(m_playlist->playbackMode() == TTK::PlayMode::Once)
-        {
-            setStopState();
-            return;
-        }
+        TTK_SIGNLE_SHOT(playNextTrack, TTK_SLOT);
+    }
+}
 
-        m_playlist->setCurrentIndex(TTK_LOW_LEVEL);
-        if(m_playlist->playbackMode() == TTK::PlayMode::Order && m_playlist->currentIndex() == -1)
-        {
-            setStopState();
-            return;
-        }
+void MusicPlayer::updateDuration()
+{
+    const qint64 d = duration();
+    if(d > 0 && d != m_duration)
+    {
+        Q_EMIT durationChanged(m_duration = d);
+        Q_EMIT positionChanged(position());
+    }
+}
+
+void MusicPlayer::prepareNextTrack()
+{
+    if(!m_preroll || !m_playlist || m_state != TTK::PlayState::Playing || m_playlist->playbackMode() == TTK::PlayMode::Once)
+    {
+        return;
+    }
 
+    const QString &path = m_playlist->nextMediaPath();
+    if(path.isEmpty())
+    {
+        return;
+    }
+
+    ///gain is applied while decoding, so set it before the next decoder starts
+    applyReplayGain(path);
+
+    ///queue the next source, engine opens and primes its decoder before current track ends
+    if(m_core->play(path, true) && m_core->nextTrackAccepted())
+    {
+        m_nextMedia = path;
+        TTK_INFO_STREAM("Pre-roll next track" << path);
+    }
+    else
+    {
+        m_nextMedia.clear();
+        applyReplayGain(m_currentMedia);
+    }
+}
+
+void MusicPlayer::switchNextTrack()
+{
+    if(m_nextMedia.isEmpty() || m_core->path() != m_nextMedia)
+    {
+        updateDuration();
+        return;
+    }
+
+    const QString path = m_nextMedia;
+    m_nextMedia.clear();
+
+    m_playlist->setCurrentIndex(TTK_LOW_LEVEL);
+    m_currentMedia = m_playlist->currentMediaPath();
+
+    if(m_currentMedia != path)
+    {
+        ///playlist changed after pre-roll, play the right one
         play();
+        return;
     }
+
+    setTrackGap();
+    m_duration = 0;
+    m_position = 0;
+    updateDuration();
+    Q_EMIT positionChanged(0);
 }
 
-void MusicPlayer::generateDuration()
+void MusicPlayer::trackFinished()
 {
-    const qint64 d = duration();
-    if((d == 0 || m_duration == d) && m_durationTimes++ < 10)
+    m_trackEndTime = QDateTime::currentMSecsSinceEpoch();
+    m_finishPending = true;
+
+    if(m_core->state() == Qmmp::Stopped)
     {
-        TTK_SIGNLE_SHOT(generateDuration, TTK_SLOT);
+        TTK_SIGNLE_SHOT(playNextTrack, TTK_SLOT);
     }
-    else
+}
+
+void MusicPlayer::playNextTrack()
+{
+    if(!m_finishPending)
     {
-        Q_EMIT durationChanged(m_duration = d);
-        Q_EMIT positionChanged(position());
+        return;
     }
+
+    m_finishPending = false;
+    if(m_playlist->playbackMode() == TTK::PlayMode::Once)
+    {
+        setStopState();
+        return;
+    }
+
+    m_playlist->setCurrentIndex(TTK_LOW_LEVEL);
+    if(m_playlist->playbackMode() == TTK::PlayMode::Order && m_playlist->currentIndex() == -1)
+    {
+        setStopState();
+        return;
+    }
+
+    m_gapPending = true;
+    play();
 }
 
 void MusicPlayer::setStopState()
@@ -275,3 +466,45 @@ void MusicPlayer::setCurrentPlayState(TTK::PlayState state)
     m_state = state;
     Q_EMIT stateChanged(m_state);
 }
+
+void MusicPlayer::setTrackGap()
+{
+    m_gapPending = false;
+    if(m_trackEndTime < 0)
+    {
+        return;
+    }
+
+    m_trackGap = qMax(QDateTime::currentMSecsSinceEpoch() - m_trackEndTime, qint64(0));
+    m_trackEndTime = -1;
+    TTK_INFO_STREAM("Track gap" << m_trackGap << "ms");
+}
+
+void MusicPlayer::applyReplayGain(const QString &path)
+{
+    QmmpSettings *settings = QmmpSettings::instance();
+    MusicReplayGainItem item;
+
+    if(path.isEmpty() || settings->replayGainMode() == QmmpSettings::REPLAYGAIN_DISABLED || !G_REPLAYGAIN_INDEX_PTR->find(path, item))
+    {
+        if(m_gainOverride)
+        {
+            ///restore user default gain
+            m_gainOverride = false;
+            settings->setReplayGainSettings(settings->replayGainMode(), settings->replayGainPreamp(), m_defaultGain, settings->replayGainPreventClipping());
+            QFile::remove(REPLAYGAIN_DEFAULT_PATH);
+        }
+        return;
+    }
+
+    if(!m_gainOverride)
+    {
+        m_gainOverride = true;
+        m_defaultGain = settings->replayGainDefaultGain();
+        saveDefaultGain(m_defaultGain);
+    }
+
+    ///tracks without replay gain tags use default gain, so analyzed gain is applied through it
+    const double gain = settings->replayGainMode() == QmmpSettings::REPLAYGAIN_ALBUM ? item.m_albumGain : item.m_trackGain;
+    settings->setReplayGainSettings(settings->replayGainMode(), settings->replayGainPreamp(), gain, settings->replayGainPreventClipping());
+}
@@ -104,6 +104,28 @@ public:
      */
     Enhance enhanced() const;
 
+    /*!
+     * Set gapless pre-roll enable or disable.
+     */
+    void setPrerollEnabled(bool enabled);
+    /*!
+     * Get gapless pre-roll enable or disable.
+     */
+    bool isPrerollEnabled() const;
+    /*!
+     * Set position changed notify granularity in milliseconds.
+     */
+    void setPositionGranularity(int msec);
+    /*!
+     * Get position changed notify granularity in milliseconds.
+     */
+    int positionGranularity() const;
+
+    /*!
+     * Get the measured gap between the last two tracks in milliseconds, -1 means not measured.
+     */
+    qint64 lastTrackGap() const;
+
 Q_SIGNALS:
     /*!
      * Current state changed.
@@ -146,13 +168,33 @@ public Q_SLOTS:
 
 private Q_SLOTS:
     /*!
-     * Player one second time out.
+     * Engine elapsed time changed.
+     */
+    void elapsedChanged(qint64 time);
+    /*!
+     * Engine state changed.
      */
-    void update();
+    void updateState();
     /*!
-     * Generate current duration by time out.
+     * Update current duration when engine knows it.
      */
-    void generateDuration();
+    void updateDuration();
+    /*!
+     * Prepare the upcoming track before current track ends.
+     */
+    void prepareNextTrack();
+    /*!
+     * Switch to the prepared track when engine starts it.
+     */
+    void switchNextTrack();
+    /*!
+     * Current track finished.
+     */
+    void trackFinished();
+    /*!
+     * Play the next track after current track finished.
+     */
+    void playNextTrack();
 
 private:
     /*!
@@ -163,16 +205,35 @@ private:
      * set current play state.
      */
     void setCurrentPlayState(TTK::PlayState state);
+    /*!
+     * Save the measured track gap.
+     */
+    void setTrackGap();
+    /*!
+     * Apply analyzed replay gain of given track from sidecar index.
+     */
+    void applyReplayGain(const QString &path);
 
     MusicPlaylist *m_playlist;
     TTK::PlayState m_state;
     SoundCore *m_core;
-    QTimer m_timer;
     QString m_currentMedia;
+    QString m_nextMedia;
     Enhance m_enhance;
     qint64 m_duration;
+    qint64 m_position;
+    int m_granularity;
+    qint64 m_effectSecond;
+
+    bool m_preroll;
+    bool m_gapPending;
+    bool m_finishPending;
+    qint64 m_trackEndTime;
+    qint64 m_trackGap;
+
+    bool m_gainOverride;
+    double m_defaultGain;
 
-    int m_durationTimes;
     int m_volumeMusic3D;
     float m_posOnCircle;
 
@@ -26,12 +26,18 @@ void MusicPlaylist::Shuffle::initialize(const MusicPlayItemList &items)
         m_index = -1;
         m_data = items;
         std::shuffle(m_data.begin(), m_data.end(), std::default_random_engine(std::random_device()()));
+
+        m_dataIndex.clear();
+        for(int i = m_data.count() - 1; i >= 0; --i)
+        {
+            m_dataIndex.insert(m_data[i], i);
+        }
     }
 }
 
 void MusicPlaylist::Shuffle::setCurrentIndex(const MusicPlayItem &item)
 {
-    m_index = m_data.indexOf(item);
+    m_index = m_dataIndex.value(item, -1);
 }
 
 MusicPlayItem MusicPlaylist::Shuffle::setCurrentIndex(int index)
@@ -62,11 +68,25 @@ MusicPlayItem MusicPlaylist::Shuffle::setCurrentIndex(int index)
     return m_data[m_index];
 }
 
+MusicPlayItem MusicPlaylist::Shuffle::nextItem() const
+{
+    if(m_data.isEmpty())
+    {
+        return {};
+    }
+
+    const int index = m_index + 1;
+    return m_data[index >= m_data.count() ? 0 : index];
+}
+
 
 MusicPlaylist::MusicPlaylist(QObject *parent)
     : QObject(parent),
       m_currentIndex(-1),
-      m_playbackMode(TTK::PlayMode::Order)
+      m_playbackMode(TTK::PlayMode::Order),
+      m_nextIndex(-1),
+      m_nextPrepared(false),
+      m_indexDirty(false)
 {
     TTK::initRandom();
 }
@@ -74,6 +94,7 @@ MusicPlaylist::MusicPlaylist(QObject *parent)
 void MusicPlaylist::setShuffleMode(bool shuffle)
 {
     m_shuffle.setEnabled(shuffle);
+    m_nextPrepared = false;
 }
 
 TTK::PlayMode MusicPlaylist::playbackMode() const
@@ -84,6 +105,7 @@ TTK::PlayMode MusicPlaylist::playbackMode() const
 void MusicPlaylist::setPlaybackMode(TTK::PlayMode mode)
 {
     m_playbackMode = mode;
+    m_nextPrepared = false;
     Q_EMIT playbackModeChanged(m_playbackMode);
 }
 
@@ -121,6 +143,72 @@ bool MusicPlaylist::isSameMediaPath(const QString &path) const
     return item.m_path == path;
 }
 
+MusicPlayItem MusicPlaylist::nextItem()
+{
+    m_nextPrepared = false;
+    if(m_mediaList.isEmpty())
+    {
+        return {};
+    }
+
+    m_shuffle.initialize(m_mediaList);
+
+    int index = m_currentIndex;
+    if(!m_queueList.isEmpty())
+    {
+        index = m_queueList.front().m_playlistRow;
+    }
+    else
+    {
+        switch(m_playbackMode)
+        {
+            case TTK::PlayMode::OneLoop: break;
+            case TTK::PlayMode::Order:
+            {
+                if(++index >= m_mediaList.count())
+                {
+                    index = -1;
+                }
+                break;
+            }
+            case TTK::PlayMode::ListLoop:
+            {
+                if(++index >= m_mediaList.count())
+                {
+                    index = 0;
+                }
+                break;
+            }
+            case TTK::PlayMode::Random:
+            {
+                index = m_shuffle.isEnabled() ? find(m_shuffle.nextItem()) : (TTK::random() % m_mediaList.count());
+                break;
+            }
+            case TTK::PlayMode::Once: index = -1; break;
+            default: break;
+        }
+    }
+
+    if(index < 0 || index >= m_mediaList.count())
+    {
+        return {};
+    }
+
+    m_nextIndex = index;
+    m_nextPrepared = true;
+    return m_mediaList[index];
+}
+
+QString MusicPlaylist::nextMediaPath()
+{
+    const MusicPlayItem &item = nextItem();
+    if(item.m_playlistRow == MUSIC_NETWORK_LIST)
+    {
+        return TTK::generateNetworkSongPath(item.m_path);
+    }
+    return item.m_path;
+}
+
 const MusicPlayItemList& MusicPlaylist::mediaList() const
 {
     return m_mediaList;
@@ -144,6 +232,8 @@ bool MusicPlaylist::isEmpty() const
 void MusicPlaylist::clear()
 {
     m_mediaList.clear();
+    m_mediaIndex.clear();
+    m_indexDirty = false;
     removeQueue();
 }
 
@@ -168,52 +258,77 @@ void MusicPlaylist::update(const TTK::IndexPropertyList &indexs)
 {
     updatePlayItems(indexs, m_mediaList);
     updatePlayItems(indexs, m_queueList);
+    m_nextPrepared = false;
+    m_indexDirty = true;
 }
 
 int MusicPlaylist::find(const MusicPlayItem &item) const
 {
-    return m_mediaList.indexOf(item);
+    updateMediaIndex();
+    const auto it = m_mediaIndex.constFind(item);
+    return it == m_mediaIndex.constEnd() ? -1 : it.value().front();
 }
 
 int MusicPlaylist::find(int playlistRow, const QString &content, int from)
 {
-    return m_mediaList.indexOf({playlistRow, content}, from);
+    updateMediaIndex();
+    const auto it = m_mediaIndex.constFind({playlistRow, content});
+    if(it == m_mediaIndex.constEnd())
+    {
+        return -1;
+    }
+
+    const TTKIntList &positions = it.value();
+    const auto pos = std::lower_bound(positions.begin(), positions.end(), from);
+    return pos == positions.end() ? -1 : *pos;
 }
 
 void MusicPlaylist::add(int playlistRow, const QString &content)
 {
     clear();
-    m_mediaList << MusicPlayItem(playlistRow, content);
+    append(playlistRow, content);
 }
 
 void MusicPlaylist::add(int playlistRow, const QStringList &items)
 {
     clear();
-    for(const QString &path : qAsConst(items))
-    {
-        m_mediaList << MusicPlayItem(playlistRow, path);
-    }
+    append(playlistRow, items);
 }
 
 void MusicPlaylist::append(int playlistRow, const QString &content)
 {
-    m_mediaList << MusicPlayItem(playlistRow, content);
+    const MusicPlayItem item(playlistRow, content);
+    if(!m_indexDirty)
+    {
+        m_mediaIndex[item] << m_mediaList.count();
+    }
+
+    m_mediaList << item;
+    m_nextPrepared = false;
 }
 
 void MusicPlaylist::append(int playlistRow, const QStringList &items)
 {
     for(const QString &path : qAsConst(items))
     {
-        m_mediaList << MusicPlayItem(playlistRow, path);
+        append(playlistRow, path);
     }
 }
 
 void MusicPlaylist::appendQueue(int playlistRow, const QString &content)
 {
     const int index = m_currentIndex + 1;
-    (index != m_mediaList.count()) ? m_mediaList.insert(index, {playlistRow, content})
-                                   : m_mediaList.append({playlistRow, content});
+    if(index != m_mediaList.count())
+    {
+        m_mediaList.insert(index, {playlistRow, content});
+        m_indexDirty = true;
+    }
+    else
+    {
+        append(playlistRow, content);
+    }
     m_queueList << MusicPlayItem(index + m_queueList.count(), content);
+    m_nextPrepared = false;
 }
 
 bool MusicPlaylist::remove(int pos)
@@ -223,7 +338,7 @@ bool MusicPlaylist::remove(int pos)
         return false;
     }
 
-    m_mediaList.removeAt(pos);
+    removeMedia(pos);
     removeQueue();
     return true;
 }
@@ -233,16 +348,97 @@ int MusicPlaylist::remove(int playlistRow, const QString &content)
     const int index = find(playlistRow, content);
     if(index != -1)
     {
-        m_mediaList.removeAt(index);
+        removeMedia(index);
         removeQueue();
     }
 
     return index;
 }
 
+TTKIntList MusicPlaylist::remove(int playlistRow, const QStringList &items)
+{
+    TTKIntList positions;
+    QSet<MusicPlayItem> removes;
+    for(const QString &path : qAsConst(items))
+    {
+        removes.insert({playlistRow, path});
+    }
+
+    MusicPlayItemList medias;
+    for(int i = 0; i < m_mediaList.count(); ++i)
+    {
+        const MusicPlayItem &item = m_mediaList[i];
+        if(removes.contains(item))
+        {
+            positions.prepend(i);
+        }
+        else
+        {
+            medias << item;
+        }
+    }
+
+    if(!positions.isEmpty())
+    {
+        m_mediaList = medias;
+        m_indexDirty = true;
+        removeQueue();
+    }
+    return positions;
+}
+
 void MusicPlaylist::removeQueue()
 {
     m_queueList.clear();
+    m_nextPrepared = false;
+}
+
+void MusicPlaylist::updateMediaIndex() const
+{
+    if(!m_indexDirty)
+    {
+        return;
+    }
+
+    m_mediaIndex.clear();
+    for(int i = 0; i < m_mediaList.count(); ++i)
+    {
+        m_mediaIndex[m_mediaList[i]] << i;
+    }
+    m_indexDirty = false;
+}
+
+void MusicPlaylist::removeMedia(int pos)
+{
+    if(!m_indexDirty)
+    {
+        const auto it = m_mediaIndex.find(m_mediaList[pos]);
+        if(it != m_mediaIndex.end())
+        {
+            it.value().removeOne(pos);
+            if(it.value().isEmpty())
+            {
+                m_mediaIndex.erase(it);
+            }
+        }
+
+        // later positions move forward by one, items are not hashed again
+        if(pos != m_mediaList.count() - 1)
+        {
+            for(auto it = m_mediaIndex.begin(); it != m_mediaIndex.end(); ++it)
+            {
+                for(int &index : it.value())
+                {
+                    if(index > pos)
+                    {
+                        --index;
+                    }
+                }
+            }
+        }
+    }
+
+    m_mediaList.removeAt(pos);
 }
 
 #define GENERATE_RANDOM_INDEX(index) \
@@ -252,6 +448,27 @@ void MusicPlaylist::setCurrentIndex(int index)
 {
     m_shuffle.initialize(m_mediaList);
 
+    if(index == TTK_LOW_LEVEL && m_nextPrepared)
+    {
+        ///commit the item prepared by pre-roll, so that player and playlist stay in sync
+        m_nextPrepared = false;
+        m_currentIndex = m_nextIndex;
+
+        if(!m_queueList.isEmpty())
+        {
+            m_queueList.removeFirst();
+        }
+
+        if(m_playbackMode == TTK::PlayMode::Random && m_shuffle.isEnabled())
+        {
+            m_shuffle.setCurrentIndex(currentItem());
+        }
+
+        Q_EMIT currentIndexChanged(m_currentIndex);
+        return;
+    }
+
+    m_nextPrepared = false;
     if(index == TTK_LOW_LEVEL)
     {
         switch(m_playbackMode)
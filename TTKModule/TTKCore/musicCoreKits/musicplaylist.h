@@ -54,6 +54,12 @@ struct TTK_MODULE_EXPORT MusicPlayItem
 };
 TTK_DECLARE_LIST(MusicPlayItem);
 
+inline uint qHash(const MusicPlayItem &item, uint seed = 0)
+{
+    Q_UNUSED(seed);
+    return qHash(item.m_path) ^ uint(item.m_playlistRow);
+}
+
 static constexpr int PLAY_NEXT_LEVEL = -123;
 static constexpr int PLAY_PREVIOUS_LEVEL = -321;
 
@@ -101,6 +107,16 @@ public:
      */
     bool isSameMediaPath(const QString &path) const;
 
+    /*!
+     * Prepare the upcoming play item without changing current index.
+     * The prepared item is committed by the next setCurrentIndex(TTK_LOW_LEVEL) call.
+     */
+    MusicPlayItem nextItem();
+    /*!
+     * Get the upcoming play music media path.
+     */
+    QString nextMediaPath();
+
     /*!
      * Get all music media path.
      */
@@ -167,6 +183,11 @@ public:
      * Remove music media from current medias by index pos.
      */
     int remove(int playlistRow, const QString &content);
+    /*!
+     * Remove all music medias matched by index and contents.
+     * Return removed positions in descending order.
+     */
+    TTKIntList remove(int playlistRow, const QStringList &items);
     /*!
      * Remove music all queue media.
      */
@@ -193,10 +214,23 @@ public Q_SLOTS:
     void setCurrentIndex(int playlistRow, const QString &path);
 
 private:
+    /*!
+     * Rebuild media position index if it is out of date.
+     */
+    void updateMediaIndex() const;
+    /*!
+     * Remove media item by position and update position index in place.
+     */
+    void removeMedia(int pos);
+
     int m_currentIndex;
     MusicPlayItemList m_mediaList;
     MusicPlayItemList m_queueList;
     TTK::PlayMode m_playbackMode;
+    int m_nextIndex;
+    bool m_nextPrepared;
+    mutable bool m_indexDirty;
+    mutable QHash<MusicPlayItem, TTKIntList> m_mediaIndex;
 
     class Shuffle
     {
@@ -226,11 +260,16 @@ private:
          * Set current play index.
          */
         MusicPlayItem setCurrentIndex(int index);
+        /*!
+         * Get the next play item without changing current index.
+         */
+        MusicPlayItem nextItem() const;
 
     private:
         int m_index;
         bool m_enable;
         MusicPlayItemList m_data;
+        QHash<MusicPlayItem, int> m_dataIndex;
 
     } m_shuffle;
 
@@ -0,0 +1,135 @@
+#include "musicreplaygainindex.h"
+
+#include <QDataStream>
+
+#define REPLAYGAIN_INDEX_PATH     APPCACHE_DIR_FULL + "replaygain"
+#define REPLAYGAIN_INDEX_MAGIC    0x544B5247
+#define REPLAYGAIN_INDEX_VERSION  1
+
+static QDataStream& operator<<(QDataStream &stream, const MusicReplayGainItem &item)
+{
+    stream << item.m_path << item.m_size << item.m_lastModified << item.m_trackGain << item.m_trackPeak << item.m_albumGain << item.m_albumPeak;
+    return stream;
+}
+
+static QDataStream& operator>>(QDataStream &stream, MusicReplayGainItem &item)
+{
+    stream >> item.m_path >> item.m_size >> item.m_lastModified >> item.m_trackGain >> item.m_trackPeak >> item.m_albumGain >> item.m_albumPeak;
+    return stream;
+}
+
+
+MusicReplayGainIndex::MusicReplayGainIndex()
+    : m_loaded(false),
+      m_changed(false)
+{
+
+}
+
+bool MusicReplayGainIndex::find(const QString &path, MusicReplayGainItem &item)
+{
+    QMutexLocker locker(&m_mutex);
+    load();
+
+    const auto it = m_items.constFind(path);
+    if(it == m_items.constEnd())
+    {
+        return false;
+    }
+
+    // the gain is only valid for the same file content
+    const QFileInfo fin(path);
+    if(fin.size() != it->m_size || fin.lastModified().toMSecsSinceEpoch() != it->m_lastModified)
+    {
+        return false;
+    }
+
+    item = it.value();
+    return true;
+}
+
+void MusicReplayGainIndex::insert(const MusicReplayGainItem &item)
+{
+    const QFileInfo fin(item.m_path);
+    MusicReplayGainItem value(item);
+    value.m_size = fin.size();
+    value.m_lastModified = fin.lastModified().toMSecsSinceEpoch();
+
+    QMutexLocker locker(&m_mutex);
+    load();
+
+    m_items.insert(item.m_path, value);
+    m_changed = true;
+}
+
+void MusicReplayGainIndex::remove(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    load();
+
+    m_changed |= m_items.remove(path) > 0;
+}
+
+bool MusicReplayGainIndex::save()
+{
+    QMutexLocker locker(&m_mutex);
+    if(!m_changed)
+    {
+        return true;
+    }
+
+    QDir().mkpath(APPCACHE_DIR_FULL);
+
+    QFile file(REPLAYGAIN_INDEX_PATH);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        TTK_ERROR_STREAM("Save replay gain index file error" << file.fileName());
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream << quint32(REPLAYGAIN_INDEX_MAGIC) << qint32(REPLAYGAIN_INDEX_VERSION) << m_items;
+    file.close();
+
+    m_changed = false;
+    return true;
+}
+
+void MusicReplayGainIndex::load()
+{
+    if(m_loaded)
+    {
+        return;
+    }
+
+    m_loaded = true;
+
+    QFile file(REPLAYGAIN_INDEX_PATH);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    quint32 magic = 0;
+    qint32 version = 0;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream >> magic >> version;
+
+    if(magic != REPLAYGAIN_INDEX_MAGIC || version != REPLAYGAIN_INDEX_VERSION)
+    {
+        TTK_WARN_STREAM("Replay gain index file version mismatch, index will be dropped");
+        file.close();
+        return;
+    }
+
+    stream >> m_items;
+    if(stream.status() != QDataStream::Ok)
+    {
+        TTK_WARN_STREAM("Replay gain index file is corrupted, index will be dropped");
+        m_items.clear();
+    }
+    file.close();
+}
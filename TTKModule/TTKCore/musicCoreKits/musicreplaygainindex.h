@@ -0,0 +1,106 @@
+#ifndef MUSICREPLAYGAININDEX_H
+#define MUSICREPLAYGAININDEX_H
+
+/***************************************************************************
+ * This file is part of the TTK Music Player project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <QMutex>
+#include "musicobject.h"
+#include "ttksingleton.h"
+
+/*! @brief The class of the music replay gain item.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct TTK_MODULE_EXPORT MusicReplayGainItem
+{
+    QString m_path;
+    qint64 m_size;
+    qint64 m_lastModified;
+    double m_trackGain;
+    double m_trackPeak;
+    double m_albumGain;
+    double m_albumPeak;
+
+    MusicReplayGainItem() noexcept
+        : m_size(-1),
+          m_lastModified(-1),
+          m_trackGain(0),
+          m_trackPeak(1),
+          m_albumGain(0),
+          m_albumPeak(1)
+    {
+
+    }
+
+    inline bool isValid() const noexcept
+    {
+        return !m_path.isEmpty();
+    }
+};
+TTK_DECLARE_LIST(MusicReplayGainItem);
+
+
+/*! @brief The class of the music replay gain sidecar index.
+ * Gains analyzed by the replay gain tool are kept here, so that playback can apply them without rescanning.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicReplayGainIndex
+{
+    TTK_DECLARE_MODULE(MusicReplayGainIndex)
+public:
+    /*!
+     * Find valid index item by file path.
+     */
+    bool find(const QString &path, MusicReplayGainItem &item);
+    /*!
+     * Insert or update index item, file size and last modified time are filled by current file.
+     */
+    void insert(const MusicReplayGainItem &item);
+    /*!
+     * Remove index item by file path.
+     */
+    void remove(const QString &path);
+
+    /*!
+     * Save index items to local file.
+     */
+    bool save();
+
+private:
+    /*!
+     * Object constructor.
+     */
+    MusicReplayGainIndex();
+
+    /*!
+     * Load index items from local file.
+     */
+    void load();
+
+    bool m_loaded, m_changed;
+    QMutex m_mutex;
+    QMap<QString, MusicReplayGainItem> m_items;
+
+    TTK_DECLARE_SINGLETON_CLASS(MusicReplayGainIndex)
+
+};
+
+#define G_REPLAYGAIN_INDEX_PTR makeMusicReplayGainIndex()
+TTK_MODULE_EXPORT MusicReplayGainIndex* makeMusicReplayGainIndex();
+
+#endif // MUSICREPLAYGAININDEX_H
@@ -0,0 +1,85 @@
+#include "musicsettingmanager.h"
+
+static constexpr int SETTING_GROUP_COUNT = 0xC;
+static constexpr int SETTING_GROUP_SIZE = 0x10;
+
+MusicSettingSnapshot::MusicSettingSnapshot()
+    : m_values(SETTING_GROUP_COUNT * SETTING_GROUP_SIZE),
+      m_contains(SETTING_GROUP_COUNT * SETTING_GROUP_SIZE, false),
+      m_count(0)
+{
+
+}
+
+int MusicSettingSnapshot::index(int type) noexcept
+{
+    const int group = (type >> 12) - 1;
+    const int offset = type & 0xFFF;
+    if(type < 0 || group < 0 || group >= SETTING_GROUP_COUNT || offset >= SETTING_GROUP_SIZE)
+    {
+        return -1;
+    }
+    return group * SETTING_GROUP_SIZE + offset;
+}
+
+
+MusicSettingManager::MusicSettingManager(QObject *parent)
+    : QObject(parent),
+      m_snapshot(std::make_shared<MusicSettingSnapshot>())
+{
+    qRegisterMetaType<MusicSettingManager::Config>("MusicSettingManager::Config");
+}
+
+void MusicSettingManager::setValue(Config type, const QVariant &var)
+{
+    const int index = MusicSettingSnapshot::index(type);
+    if(index < 0)
+    {
+        TTK_WARN_STREAM("Setting config type is invalid" << type);
+        return;
+    }
+
+    m_mutex.lock();
+    const std::shared_ptr<const MusicSettingSnapshot> current = std::atomic_load(&m_snapshot);
+    if(current->m_contains[index] && current->m_values[index] == var)
+    {
+        m_mutex.unlock();
+        return;
+    }
+
+    // copy on write, readers holding the old snapshot are not affected
+    std::shared_ptr<MusicSettingSnapshot> snapshot = std::make_shared<MusicSettingSnapshot>(*current);
+    if(!snapshot->m_contains[index])
+    {
+        snapshot->m_contains[index] = true;
+        ++snapshot->m_count;
+    }
+    snapshot->m_values[index] = var;
+
+    std::atomic_store(&m_snapshot, std::shared_ptr<const MusicSettingSnapshot>(snapshot));
+    m_mutex.unlock();
+
+    Q_EMIT valueChanged(type, var);
+}
+
+QVariant MusicSettingManager::value(Config type) const
+{
+    const int index = MusicSettingSnapshot::index(type);
+    return index < 0 ? QVariant() : std::atomic_load(&m_snapshot)->m_values[index];
+}
+
+std::shared_ptr<const MusicSettingSnapshot> MusicSettingManager::snapshot() const
+{
+    return std::atomic_load(&m_snapshot);
+}
+
+int MusicSettingManager::count() const
+{
+    return std::atomic_load(&m_snapshot)->m_count;
+}
+
+bool MusicSettingManager::contains(Config type) const
+{
+    const int index = MusicSettingSnapshot::index(type);
+    return index >= 0 && std::atomic_load(&m_snapshot)->m_contains[index];
+}
@@ -19,10 +19,37 @@
  * with this program; If not, see <http://www.gnu.org/licenses/>.
  ***************************************************************************/
 
+#include <memory>
+#include <QMutex>
 #include <QMetaEnum>
 #include "musicobject.h"
 #include "ttksingleton.h"
 
+/*! @brief The class of the setting value type by config type.
+ * Only declared, every config type must define its value type.
+ * @author Greedysky <greedysky@163.com>
+ */
+template <int T>
+struct MusicSettingType;
+
+/*! @brief The class of the setting values snapshot.
+ * Values are stored flat, indexed by config group and offset.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct TTK_MODULE_EXPORT MusicSettingSnapshot
+{
+    QVector<QVariant> m_values;
+    QVector<bool> m_contains;
+    int m_count;
+
+    MusicSettingSnapshot();
+
+    /*!
+     * Get flat index by config type, -1 means invalid type.
+     */
+    static int index(int type) noexcept;
+};
+
 /*! @brief The class of the paramater setting manager.
  * @author Greedysky <greedysky@163.com>
  */
@@ -148,60 +175,73 @@ public:
     /*!
      * Set current value by Config Type.
      */
-    inline void setValue(Config type, const QVariant &var)
-    {
-        m_parameter[type] = var;
-    }
+    void setValue(Config type, const QVariant &var);
 
     /*!
      * Set current value by String Type.
      */
     inline void setValue(const QString &stype, const QVariant &var)
     {
-        m_parameter[stringToEnum(stype)] = var;
+        setValue(stringToEnum(stype), var);
     }
 
     /*!
      * Get current value by Config Type.
      */
-    inline QVariant value(Config type) const
-    {
-        return m_parameter[type];
-    }
+    QVariant value(Config type) const;
 
     /*!
      * Get current value by String Type.
      */
     inline QVariant value(const QString &stype) const
     {
-        return m_parameter[stringToEnum(stype)];
+        return value(stringToEnum(stype));
     }
 
     /*!
-     * Get parameter count.
+     * Get current typed value by Config Type at compile time.
      */
-    inline int count() const
+    template <Config T>
+    inline typename MusicSettingType<T>::Type value() const
     {
-        return m_parameter.count();
+        return value(T).template value<typename MusicSettingType<T>::Type>();
     }
 
+    /*!
+     * Get current values snapshot, values are never changed after taken.
+     */
+    std::shared_ptr<const MusicSettingSnapshot> snapshot() const;
+
+    /*!
+     * Get parameter count.
+     */
+    int count() const;
+
     /*!
      * Current parameter is empty.
      */
     inline bool isEmpty() const
     {
-        return m_parameter.isEmpty();
+        return count() == 0;
     }
 
     /*!
      * Current parameter contains type.
      */
-    inline bool contains(Config type) const
-    {
-        return m_parameter.contains(type);
-    }
+    bool contains(Config type) const;
+
+Q_SIGNALS:
+    /*!
+     * Current value changed by Config Type.
+     */
+    void valueChanged(MusicSettingManager::Config type, const QVariant &value);
 
 private:
+    /*!
+     * Object constructor.
+     */
+    explicit MusicSettingManager(QObject *parent = nullptr);
+
     /*!
      * Convert String type to Config Type.
      */
@@ -213,13 +253,117 @@ private:
         return TTKStaticCast(Config, key);
     }
 
-    QVariant m_variant;
-    QMap<Config, QVariant> m_parameter;
+    QMutex m_mutex;
+    std::shared_ptr<const MusicSettingSnapshot> m_snapshot;
 
     TTK_DECLARE_SINGLETON_CLASS(MusicSettingManager)
 
 };
 
+Q_DECLARE_METATYPE(MusicSettingManager::Config)
+
+#define TTK_DECLARE_SETTING_TYPE(Config, Class) \
+    template <> \
+    struct MusicSettingType<MusicSettingManager::Config> { using Type = Class; }
+
+TTK_DECLARE_SETTING_TYPE(ScreenSize, QSize);
+TTK_DECLARE_SETTING_TYPE(WidgetPosition, QPoint);
+TTK_DECLARE_SETTING_TYPE(WidgetSize, QSize);
+TTK_DECLARE_SETTING_TYPE(ConfigVersion, QString);
+TTK_DECLARE_SETTING_TYPE(PlayMode, int);
+TTK_DECLARE_SETTING_TYPE(Volume, int);
+TTK_DECLARE_SETTING_TYPE(LastPlayIndex, QStringList);
+TTK_DECLARE_SETTING_TYPE(LanguageIndex, int);
+TTK_DECLARE_SETTING_TYPE(StartUpMode, bool);
+TTK_DECLARE_SETTING_TYPE(StartUpPlayMode, int);
+TTK_DECLARE_SETTING_TYPE(CloseEventMode, bool);
+TTK_DECLARE_SETTING_TYPE(CloseNetWorkMode, bool);
+TTK_DECLARE_SETTING_TYPE(FileAssociationMode, bool);
+TTK_DECLARE_SETTING_TYPE(FileAssociationValue, QString);
+TTK_DECLARE_SETTING_TYPE(WindowConciseMode, bool);
+TTK_DECLARE_SETTING_TYPE(RemoteWidgetMode, int);
+TTK_DECLARE_SETTING_TYPE(WindowQuitMode, bool);
+TTK_DECLARE_SETTING_TYPE(ExtraDevicePath, QString);
+TTK_DECLARE_SETTING_TYPE(LastFileDialogPath, QString);
+TTK_DECLARE_SETTING_TYPE(MediaLibraryPath, QString);
+TTK_DECLARE_SETTING_TYPE(BackgroundThemeValue, QString);
+TTK_DECLARE_SETTING_TYPE(BackgroundTransparent, int);
+TTK_DECLARE_SETTING_TYPE(BackgroundListTransparent, int);
+TTK_DECLARE_SETTING_TYPE(BackgroundTransparentEnable, bool);
+TTK_DECLARE_SETTING_TYPE(HotkeyEnable, bool);
+TTK_DECLARE_SETTING_TYPE(HotkeyValue, QString);
+TTK_DECLARE_SETTING_TYPE(OtherCheckUpdateEnable, bool);
+TTK_DECLARE_SETTING_TYPE(OtherReadAlbumCover, bool);
+TTK_DECLARE_SETTING_TYPE(OtherReadFileInfo, bool);
+TTK_DECLARE_SETTING_TYPE(OtherWriteAlbumCover, bool);
+TTK_DECLARE_SETTING_TYPE(OtherWriteFileInfo, bool);
+TTK_DECLARE_SETTING_TYPE(OtherSideByMode, bool);
+TTK_DECLARE_SETTING_TYPE(OtherSideByInMode, bool);
+TTK_DECLARE_SETTING_TYPE(OtherLrcKTVMode, bool);
+TTK_DECLARE_SETTING_TYPE(OtherScreenSaverEnable, bool);
+TTK_DECLARE_SETTING_TYPE(OtherScreenSaverTime, int);
+TTK_DECLARE_SETTING_TYPE(OtherScreenSaverIndex, QString);
+TTK_DECLARE_SETTING_TYPE(OtherPlaylistAutoSaveEnable, bool);
+TTK_DECLARE_SETTING_TYPE(OtherRandomShuffleMode, bool);
+TTK_DECLARE_SETTING_TYPE(OtherHighDpiScalingEnable, int);
+TTK_DECLARE_SETTING_TYPE(OtherLogTrackEnable, bool);
+TTK_DECLARE_SETTING_TYPE(RippleLowPowerMode, bool);
+TTK_DECLARE_SETTING_TYPE(RippleSpectrumEnable, bool);
+TTK_DECLARE_SETTING_TYPE(RippleSpectrumColor, QString);
+TTK_DECLARE_SETTING_TYPE(RippleSpectrumTransparent, int);
+TTK_DECLARE_SETTING_TYPE(ShowInteriorLrc, bool);
+TTK_DECLARE_SETTING_TYPE(LrcColor, int);
+TTK_DECLARE_SETTING_TYPE(LrcSize, int);
+TTK_DECLARE_SETTING_TYPE(LrcType, int);
+TTK_DECLARE_SETTING_TYPE(LrcFamily, int);
+TTK_DECLARE_SETTING_TYPE(LrcFrontgroundColor, QString);
+TTK_DECLARE_SETTING_TYPE(LrcBackgroundColor, QString);
+TTK_DECLARE_SETTING_TYPE(LrcColorTransparent, int);
+TTK_DECLARE_SETTING_TYPE(ShowDesktopLrc, bool);
+TTK_DECLARE_SETTING_TYPE(DLrcColor, int);
+TTK_DECLARE_SETTING_TYPE(DLrcSize, int);
+TTK_DECLARE_SETTING_TYPE(DLrcType, int);
+TTK_DECLARE_SETTING_TYPE(DLrcFamily, int);
+TTK_DECLARE_SETTING_TYPE(DLrcFrontgroundColor, QString);
+TTK_DECLARE_SETTING_TYPE(DLrcBackgroundColor, QString);
+TTK_DECLARE_SETTING_TYPE(DLrcColorTransparent, int);
+TTK_DECLARE_SETTING_TYPE(DLrcWindowMode, int);
+TTK_DECLARE_SETTING_TYPE(DLrcSingleLineMode, int);
+TTK_DECLARE_SETTING_TYPE(DLrcLockedMode, int);
+TTK_DECLARE_SETTING_TYPE(DLrcGeometry, QPoint);
+TTK_DECLARE_SETTING_TYPE(EqualizerEnable, int);
+TTK_DECLARE_SETTING_TYPE(EqualizerValue, QString);
+TTK_DECLARE_SETTING_TYPE(EqualizerIndex, int);
+TTK_DECLARE_SETTING_TYPE(EnhancedMusicIndex, int);
+TTK_DECLARE_SETTING_TYPE(EnhancedFadeEnable, int);
+TTK_DECLARE_SETTING_TYPE(EnhancedFadeInValue, int);
+TTK_DECLARE_SETTING_TYPE(EnhancedFadeOutValue, int);
+TTK_DECLARE_SETTING_TYPE(EnhancedEffectValue, QString);
+TTK_DECLARE_SETTING_TYPE(TimerAutoIndex, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoPlayMode, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoPlayHour, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoPlaySecond, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoPlayRepeat, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoPlayItemIndex, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoPlaySongIndex, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoStopMode, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoStopHour, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoStopSecond, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoStopRepeat, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoShutdownMode, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoShutdownHour, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoShutdownSecond, int);
+TTK_DECLARE_SETTING_TYPE(TimerAutoShutdownRepeat, int);
+TTK_DECLARE_SETTING_TYPE(DownloadMusicDirPath, QString);
+TTK_DECLARE_SETTING_TYPE(DownloadLrcDirPath, QString);
+TTK_DECLARE_SETTING_TYPE(DownloadServerIndex, int);
+TTK_DECLARE_SETTING_TYPE(DownloadCacheEnable, int);
+TTK_DECLARE_SETTING_TYPE(DownloadCacheSize, int);
+TTK_DECLARE_SETTING_TYPE(DownloadLimitEnable, int);
+TTK_DECLARE_SETTING_TYPE(DownloadDownloadLimitSize, QString);
+TTK_DECLARE_SETTING_TYPE(DownloadUploadLimitSize, QString);
+TTK_DECLARE_SETTING_TYPE(DownloadFileNameRule, QString);
+
 #define G_SETTING_PTR makeMusicSettingManager()
 TTK_MODULE_EXPORT MusicSettingManager* makeMusicSettingManager();
 
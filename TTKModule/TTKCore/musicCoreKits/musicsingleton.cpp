@@ -1,4 +1,7 @@
 #include "musicconnectionpool.h"
+#include "musicsongmetaindex.h"
+#include "musicreplaygainindex.h"
+#include "musicsonghashindex.h"
 #include "musicbackgroundmanager.h"
 #include "musicdispatchmanager.h"
 #include "musichotkeymanager.h"
@@ -31,6 +34,21 @@ MusicSettingManager* makeMusicSettingManager()
     return TTKSingleton<MusicSettingManager>::instance();
 }
 
+MusicSongMetaIndex* makeMusicSongMetaIndex()
+{
+    return TTKSingleton<MusicSongMetaIndex>::instance();
+}
+
+MusicReplayGainIndex* makeMusicReplayGainIndex()
+{
+    return TTKSingleton<MusicReplayGainIndex>::instance();
+}
+
+MusicSongHashIndex* makeMusicSongHashIndex()
+{
+    return TTKSingleton<MusicSongHashIndex>::instance();
+}
+
 MusicSingleManager* makeMusicSingleManager()
 {
     return TTKSingleton<MusicSingleManager>::instance();
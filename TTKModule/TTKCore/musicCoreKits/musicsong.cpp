@@ -7,13 +7,48 @@
 
 #include <qmmp/trackinfo.h>
 
+#include <QMutex>
+
+/// lazy file attributes can be filled from any thread while songs are shared by playlist copies
+static QMutex attributeMutex;
+
+/*! @brief The class of the song sort key compare.
+ * @author Greedysky <greedysky@163.com>
+ */
+template <typename T>
+struct MusicSongSortKeyCompare
+{
+    const QVector<T> &m_keys;
+    bool m_ascending;
+
+    MusicSongSortKeyCompare(const QVector<T> &keys, bool ascending)
+        : m_keys(keys),
+          m_ascending(ascending)
+    {
+
+    }
+
+    inline bool operator()(int a, int b) const
+    {
+        return m_ascending ? m_keys[a] < m_keys[b] : m_keys[b] < m_keys[a];
+    }
+};
+
+template <typename T>
+static void sortSongKeyIndexs(TTKIntList &indexs, const QVector<T> &keys, bool ascending)
+{
+    std::stable_sort(indexs.begin(), indexs.end(), MusicSongSortKeyCompare<T>(keys, ascending));
+}
+
 MusicSong::MusicSong() noexcept
     : m_sort(Sort::ByFileName),
+      m_attributes(true),
       m_size(0),
       m_addTime(-1),
       m_sizeStr(TTK_DEFAULT_STR),
       m_addTimeStr(TTK_DEFAULT_STR),
       m_playCount(0),
+      m_durationValue(0),
       m_name(TTK_DEFAULT_STR),
       m_path(TTK_DEFAULT_STR),
       m_format(TTK_DEFAULT_STR),
@@ -35,15 +70,87 @@ MusicSong::MusicSong(const QString &path, const QString &duration, const QString
     // replace windows \\ path to / path
     m_path.replace(TTK_WSEPARATOR, TTK_SEPARATOR);
 
+    // path is only parsed here, file attributes are fetched on demand
     const QFileInfo fin(!track ? m_path : TTK::trackRelatedPath(m_path));
 
     m_name = name.isEmpty() ? fin.completeBaseName() : name;
-    m_size = fin.size();
     m_format = TTK_FILE_SUFFIX(fin);
-    m_addTime = fin.lastModified().toMSecsSinceEpoch();
-    m_duration = duration;
+    m_attributes = false;
+    setDuration(duration);
+}
+
+MusicSong::MusicSong(const QString &path, qint64 size, qint64 addTime, const QString &duration, const QString &name) noexcept
+    : MusicSong()
+{
+    m_path = path;
+    // replace windows \\ path to / path
+    m_path.replace(TTK_WSEPARATOR, TTK_SEPARATOR);
+
+    // file attributes are given, path is only parsed without touching file system
+    const QFileInfo fin(TTK::trackRelatedPath(m_path));
+
+    m_name = name.isEmpty() ? fin.completeBaseName() : name;
+    m_format = TTK_FILE_SUFFIX(fin);
+    setDuration(duration);
+    setAttributes(size, addTime);
+}
+
+void MusicSong::setDuration(const QString &t) noexcept
+{
+    m_duration = t;
+    m_durationValue = TTK::generateSongDuration(t);
+}
+
+void MusicSong::setAttributes(qint64 size, qint64 addTime) noexcept
+{
+    QMutexLocker locker(&attributeMutex);
+    m_size = size;
+    m_addTime = addTime;
     m_addTimeStr = QString::number(m_addTime);
     m_sizeStr = TTK::Number::sizeByteToLabel(m_size);
+    m_attributes = true;
+}
+
+void MusicSong::setAddTimeStr(const QString &t) noexcept
+{
+    fetchAttributes();
+    QMutexLocker locker(&attributeMutex);
+    m_addTimeStr = t;
+}
+
+QString MusicSong::addTimeStr() const noexcept
+{
+    fetchAttributes();
+    QMutexLocker locker(&attributeMutex);
+    return m_addTimeStr;
+}
+
+qint64 MusicSong::addTime() const noexcept
+{
+    fetchAttributes();
+    QMutexLocker locker(&attributeMutex);
+    return m_addTime;
+}
+
+void MusicSong::setSizeStr(const QString &s) noexcept
+{
+    fetchAttributes();
+    QMutexLocker locker(&attributeMutex);
+    m_sizeStr = s;
+}
+
+QString MusicSong::sizeStr() const noexcept
+{
+    fetchAttributes();
+    QMutexLocker locker(&attributeMutex);
+    return m_sizeStr;
+}
+
+qint64 MusicSong::size() const noexcept
+{
+    fetchAttributes();
+    QMutexLocker locker(&attributeMutex);
+    return m_size;
 }
 
 QString MusicSong::title() const noexcept
@@ -67,9 +174,9 @@ bool MusicSong::operator< (const MusicSong &other) const noexcept
     {
         case Sort::ByFileName: return m_name < other.m_name;
         case Sort::BySinger: return artist() < other.artist();
-        case Sort::ByFileSize: return m_size < other.m_size;
-        case Sort::ByAddTime: return m_addTime < other.m_addTime;
-        case Sort::ByDuration: return m_duration < other.m_duration;
+        case Sort::ByFileSize: return size() < other.size();
+        case Sort::ByAddTime: return addTime() < other.addTime();
+        case Sort::ByDuration: return m_durationValue < other.m_durationValue;
         case Sort::ByPlayCount: return m_playCount < other.m_playCount;
         default: break;
     }
@@ -82,15 +189,46 @@ bool MusicSong::operator> (const MusicSong &other) const noexcept
     {
         case Sort::ByFileName: return m_name > other.m_name;
         case Sort::BySinger: return artist() > other.artist();
-        case Sort::ByFileSize: return m_size > other.m_size;
-        case Sort::ByAddTime: return m_addTime > other.m_addTime;
-        case Sort::ByDuration: return m_duration > other.m_duration;
+        case Sort::ByFileSize: return size() > other.size();
+        case Sort::ByAddTime: return addTime() > other.addTime();
+        case Sort::ByDuration: return m_durationValue > other.m_durationValue;
         case Sort::ByPlayCount: return m_playCount > other.m_playCount;
         default: break;
     }
     return false;
 }
 
+bool MusicSong::hasAttributes() const noexcept
+{
+    QMutexLocker locker(&attributeMutex);
+    return m_attributes;
+}
+
+void MusicSong::fetchAttributes() const noexcept
+{
+    if(hasAttributes())
+    {
+        return;
+    }
+
+    // file system is read out of the lock, the first finished result is kept
+    const QFileInfo fin(TTK::trackRelatedPath(m_path));
+    const qint64 size = fin.size();
+    const qint64 addTime = fin.lastModified().toMSecsSinceEpoch();
+
+    QMutexLocker locker(&attributeMutex);
+    if(m_attributes)
+    {
+        return;
+    }
+
+    m_size = size;
+    m_addTime = addTime;
+    m_addTimeStr = QString::number(m_addTime);
+    m_sizeStr = TTK::Number::sizeByteToLabel(m_size);
+    m_attributes = true;
+}
+
 
 bool TTK::playlistRowValid(int index)
 {
@@ -134,18 +272,19 @@ MusicSongList TTK::generateSongList(const QString &path)
     MusicSongList songs;
     MusicSongMeta meta;
 
-    if(!meta.read(path))
+    if(!meta.read(path, true))
     {
         return songs;
     }
 
     const int size = meta.songMetaCount();
+    const bool readInfo = G_SETTING_PTR->value<MusicSettingManager::OtherReadFileInfo>();
     for(int i = 0; i < size; ++i)
     {
         meta.setSongMetaIndex(i);
 
         QString name;
-        if(G_SETTING_PTR->value(MusicSettingManager::OtherReadFileInfo).toBool())
+        if(readInfo)
         {
             name = TTK::generateSongName(meta.title(), meta.artist());
         }
@@ -166,6 +305,92 @@ MusicSongList TTK::generateSongList(const QString &path)
     return songs;
 }
 
+qint64 TTK::generateSongDuration(const QString &duration)
+{
+    qint64 value = 0;
+    const QStringList &parts = duration.split(":");
+    if(parts.count() < 2)
+    {
+        return value;
+    }
+
+    for(const QString &part : qAsConst(parts))
+    {
+        bool ok = false;
+        const int v = part.trimmed().toInt(&ok);
+        if(!ok)
+        {
+            return 0;
+        }
+        value = value * 60 + v;
+    }
+    return value * TTK_DN_S2MS;
+}
+
+TTKIntList TTK::sortSongIndexs(const MusicSongList &songs, MusicSong::Sort sort, bool ascending)
+{
+    const int count = songs.count();
+
+    TTKIntList indexs;
+    indexs.reserve(count);
+    for(int i = 0; i < count; ++i)
+    {
+        indexs << i;
+    }
+
+    switch(sort)
+    {
+        case MusicSong::Sort::ByFileName:
+        case MusicSong::Sort::BySinger:
+        {
+            const bool singer = sort == MusicSong::Sort::BySinger;
+            QVector<QString> keys(count);
+            for(int i = 0; i < count; ++i)
+            {
+                keys[i] = singer ? songs[i].artist() : songs[i].name();
+            }
+            sortSongKeyIndexs(indexs, keys, ascending);
+            break;
+        }
+        case MusicSong::Sort::ByFileSize:
+        case MusicSong::Sort::ByAddTime:
+        case MusicSong::Sort::ByDuration:
+        case MusicSong::Sort::ByPlayCount:
+        {
+            QVector<qint64> keys(count);
+            for(int i = 0; i < count; ++i)
+            {
+                const MusicSong &song = songs[i];
+                switch(sort)
+                {
+                    case MusicSong::Sort::ByFileSize: keys[i] = song.size(); break;
+                    case MusicSong::Sort::ByAddTime: keys[i] = song.addTime(); break;
+                    case MusicSong::Sort::ByDuration: keys[i] = song.durationValue(); break;
+                    default: keys[i] = song.playCount(); break;
+                }
+            }
+            sortSongKeyIndexs(indexs, keys, ascending);
+            break;
+        }
+        default: break;
+    }
+    return indexs;
+}
+
+void TTK::sortSongList(MusicSongList *songs, MusicSong::Sort sort, bool ascending)
+{
+    const TTKIntList &indexs = TTK::sortSongIndexs(*songs, sort, ascending);
+
+    MusicSongList result;
+    result.reserve(indexs.count());
+    for(int index : qAsConst(indexs))
+    {
+        result << songs->at(index);
+    }
+
+    songs->swap(result);
+}
+
 QString TTK::generateNetworkSongTime(const QString &path)
 {
     MusicSongMeta meta;
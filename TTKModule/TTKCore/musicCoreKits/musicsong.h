@@ -45,6 +45,7 @@ public:
     MusicSong() noexcept;
     explicit MusicSong(const QString &path, bool track = false) noexcept;
     MusicSong(const QString &path, const QString &duration, const QString &name = {}, bool track = false) noexcept;
+    MusicSong(const QString &path, qint64 size, qint64 addTime, const QString &duration, const QString &name) noexcept;
 
     /*!
      * Get music title name.
@@ -55,22 +56,35 @@ public:
      */
     QString artist() const noexcept;
 
+    /*!
+     * Set music file attributes, which are loaded from cache or by async refresh.
+     */
+    void setAttributes(qint64 size, qint64 addTime) noexcept;
+    /*!
+     * Check music file attributes are ready or not.
+     */
+    bool hasAttributes() const noexcept;
+
     /*!
      * Set music add time string.
      */
-    inline void setAddTimeStr(const QString &t) noexcept { m_addTimeStr = t; }
+    void setAddTimeStr(const QString &t) noexcept;
     /*!
      * Get music add time string.
      */
-    inline QString addTimeStr() const noexcept { return m_addTimeStr; }
+    QString addTimeStr() const noexcept;
+    /*!
+     * Get music add time.
+     */
+    qint64 addTime() const noexcept;
     /*!
      * Set music size string.
      */
-    inline void setSizeStr(const QString &s) noexcept { m_sizeStr = s; }
+    void setSizeStr(const QString &s) noexcept;
     /*!
      * Get music size string.
      */
-    inline QString sizeStr() const noexcept { return m_sizeStr; }
+    QString sizeStr() const noexcept;
 
     /*!
      * Set music name.
@@ -99,15 +113,19 @@ public:
     /*!
      * Set music duration.
      */
-    inline void setDuration(const QString &t) noexcept { m_duration = t; }
+    void setDuration(const QString &t) noexcept;
     /*!
      * Get music duration.
      */
     inline QString duration() const noexcept { return m_duration; }
+    /*!
+     * Get music duration in milliseconds.
+     */
+    inline qint64 durationValue() const noexcept { return m_durationValue; }
     /*!
      * Get music size.
      */
-    inline qint64 size() const noexcept { return m_size; }
+    qint64 size() const noexcept;
     /*!
      * Set music play count.
      */
@@ -126,10 +144,17 @@ public:
     bool operator> (const MusicSong &other) const noexcept;
 
 private:
+    /*!
+     * Read music file attributes from file system if not ready.
+     */
+    void fetchAttributes() const noexcept;
+
     Sort m_sort;
-    qint64 m_size, m_addTime;
-    QString m_sizeStr, m_addTimeStr;
+    mutable bool m_attributes;
+    mutable qint64 m_size, m_addTime;
+    mutable QString m_sizeStr, m_addTimeStr;
     int m_playCount;
+    qint64 m_durationValue;
     QString m_name, m_path, m_format, m_duration;
 
 };
@@ -213,6 +238,19 @@ namespace TTK
      * Generate song playlist.
      */
     TTK_MODULE_EXPORT MusicSongList generateSongList(const QString &path);
+    /*!
+     * Parse song duration string like mm:ss or hh:mm:ss to milliseconds.
+     */
+    TTK_MODULE_EXPORT qint64 generateSongDuration(const QString &duration);
+
+    /*!
+     * Sort song playlist and get the index permutation, sort keys are computed once for each song.
+     */
+    TTK_MODULE_EXPORT TTKIntList sortSongIndexs(const MusicSongList &songs, MusicSong::Sort sort, bool ascending);
+    /*!
+     * Sort song playlist in place by the index permutation.
+     */
+    TTK_MODULE_EXPORT void sortSongList(MusicSongList *songs, MusicSong::Sort sort, bool ascending);
 
     /*!
      * Generate network song play time.
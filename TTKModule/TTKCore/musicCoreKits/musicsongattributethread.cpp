@@ -0,0 +1,59 @@
+#include "musicsongattributethread.h"
+#include "musicsong.h"
+
+MusicSongAttributeThread::MusicSongAttributeThread(QObject *parent)
+    : TTKAbstractThread(parent),
+      m_idle(true)
+{
+
+}
+
+MusicSongAttributeThread::~MusicSongAttributeThread()
+{
+    stop();
+}
+
+void MusicSongAttributeThread::setSongPaths(const QStringList &paths)
+{
+    m_mutex.lock();
+    m_paths = paths;
+    const bool idle = m_idle && !m_paths.isEmpty();
+    if(idle)
+    {
+        m_idle = false;
+    }
+    m_mutex.unlock();
+
+    if(idle)
+    {
+        // worker may still be returning from the last run, it is already out of the loop
+        wait();
+        start();
+    }
+}
+
+void MusicSongAttributeThread::run()
+{
+    while(m_running)
+    {
+        m_mutex.lock();
+        if(m_paths.isEmpty())
+        {
+            // go idle under the same lock, paths set after this point start a new run
+            m_idle = true;
+            m_mutex.unlock();
+            return;
+        }
+
+        const QString path = m_paths.takeFirst();
+        m_mutex.unlock();
+
+        const QFileInfo fin(TTK::trackRelatedPath(path));
+        Q_EMIT attributesChanged(path, fin.size(), fin.lastModified().toMSecsSinceEpoch());
+    }
+
+    // stopped with paths pending
+    m_mutex.lock();
+    m_idle = true;
+    m_mutex.unlock();
+}
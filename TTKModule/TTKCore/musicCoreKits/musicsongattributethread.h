@@ -0,0 +1,69 @@
+#ifndef MUSICSONGATTRIBUTETHREAD_H
+#define MUSICSONGATTRIBUTETHREAD_H
+
+/***************************************************************************
+ * This file is part of the TTK Music Player project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+
+#include <QMutex>
+#include "musicglobaldefine.h"
+#include "ttkabstractthread.h"
+
+/*! @brief The class of the song file attributes fetch thread.
+ * Songs are created without touching file system, attributes of the
+ * visible ones are read here and sent back to the owner by path.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicSongAttributeThread : public TTKAbstractThread
+{
+    Q_OBJECT
+    TTK_DECLARE_MODULE(MusicSongAttributeThread)
+public:
+    /*!
+     * Object constructor.
+     */
+    explicit MusicSongAttributeThread(QObject *parent = nullptr);
+    /*!
+     * Object destructor.
+     */
+    ~MusicSongAttributeThread();
+
+    /*!
+     * Set song paths to fetch, pending paths of the previous request are dropped.
+     */
+    void setSongPaths(const QStringList &paths);
+
+Q_SIGNALS:
+    /*!
+     * Song file attributes fetch finished.
+     */
+    void attributesChanged(const QString &path, qint64 size, qint64 addTime);
+
+private:
+    /*!
+     * Thread run now.
+     */
+    virtual void run() override final;
+
+    bool m_idle;
+    QMutex m_mutex;
+    QStringList m_paths;
+
+};
+
+#endif // MUSICSONGATTRIBUTETHREAD_H
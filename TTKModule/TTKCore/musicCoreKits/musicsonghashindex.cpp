@@ -0,0 +1,142 @@
+#include "musicsonghashindex.h"
+
+#include <QDataStream>
+
+#define SONGHASH_INDEX_PATH     APPCACHE_DIR_FULL + "hashindex"
+#define SONGHASH_INDEX_MAGIC    0x544B4849
+#define SONGHASH_INDEX_VERSION  1
+
+static QDataStream& operator<<(QDataStream &stream, const MusicSongHashItem &item)
+{
+    stream << item.m_size << item.m_lastModified << item.m_duration << item.m_partialHash << item.m_fullHash << item.m_fingerprint;
+    return stream;
+}
+
+static QDataStream& operator>>(QDataStream &stream, MusicSongHashItem &item)
+{
+    stream >> item.m_size >> item.m_lastModified >> item.m_duration >> item.m_partialHash >> item.m_fullHash >> item.m_fingerprint;
+    return stream;
+}
+
+
+MusicSongHashIndex::MusicSongHashIndex()
+    : m_loaded(false),
+      m_changed(false)
+{
+
+}
+
+bool MusicSongHashIndex::find(const QString &path, qint64 size, qint64 lastModified, MusicSongHashItem &item)
+{
+    QMutexLocker locker(&m_mutex);
+    load();
+
+    const auto it = m_items.constFind(path);
+    if(it == m_items.constEnd() || it->m_size != size || it->m_lastModified != lastModified)
+    {
+        return false;
+    }
+
+    item = it.value();
+    return true;
+}
+
+void MusicSongHashIndex::insert(const QString &path, const MusicSongHashItem &item)
+{
+    QMutexLocker locker(&m_mutex);
+    load();
+
+    m_items.insert(path, item);
+    m_changed = true;
+}
+
+void MusicSongHashIndex::remove(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    load();
+
+    m_changed |= m_items.remove(path) > 0;
+}
+
+void MusicSongHashIndex::purge()
+{
+    QMutexLocker locker(&m_mutex);
+    load();
+
+    for(auto it = m_items.begin(); it != m_items.end();)
+    {
+        if(!QFile::exists(it.key()))
+        {
+            it = m_items.erase(it);
+            m_changed = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool MusicSongHashIndex::save()
+{
+    QMutexLocker locker(&m_mutex);
+    if(!m_changed)
+    {
+        return true;
+    }
+
+    QDir().mkpath(APPCACHE_DIR_FULL);
+
+    QFile file(SONGHASH_INDEX_PATH);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        TTK_ERROR_STREAM("Save song hash index file error" << file.fileName());
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream << quint32(SONGHASH_INDEX_MAGIC) << qint32(SONGHASH_INDEX_VERSION) << m_items;
+    file.close();
+
+    m_changed = false;
+    return true;
+}
+
+void MusicSongHashIndex::load()
+{
+    if(m_loaded)
+    {
+        return;
+    }
+
+    m_loaded = true;
+
+    QFile file(SONGHASH_INDEX_PATH);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    quint32 magic = 0;
+    qint32 version = 0;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream >> magic >> version;
+
+    if(magic != SONGHASH_INDEX_MAGIC || version != SONGHASH_INDEX_VERSION)
+    {
+        TTK_WARN_STREAM("Song hash index file version mismatch, index will be rebuilt");
+        file.close();
+        return;
+    }
+
+    stream >> m_items;
+    if(stream.status() != QDataStream::Ok)
+    {
+        TTK_WARN_STREAM("Song hash index file is corrupted, index will be rebuilt");
+        m_items.clear();
+    }
+    file.close();
+}
@@ -0,0 +1,103 @@
+#ifndef MUSICSONGHASHINDEX_H
+#define MUSICSONGHASHINDEX_H
+
+/***************************************************************************
+ * This file is part of the TTK Music Player project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+
+#include <QMutex>
+#include "musicobject.h"
+#include "ttksingleton.h"
+
+/*! @brief The class of the music song hash index item.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct TTK_MODULE_EXPORT MusicSongHashItem
+{
+    qint64 m_size;
+    qint64 m_lastModified;
+    qint64 m_duration;
+    QByteArray m_partialHash;
+    QByteArray m_fullHash;
+    QByteArray m_fingerprint;
+
+    MusicSongHashItem() noexcept
+        : m_size(-1),
+          m_lastModified(-1),
+          m_duration(-1)
+    {
+
+    }
+};
+TTK_DECLARE_LIST(MusicSongHashItem);
+
+
+/*! @brief The class of the music song content hash index.
+ * Content hashes and audio fingerprints are expensive, so they are cached by file path
+ * and validated by file size and last modified time.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicSongHashIndex
+{
+    TTK_DECLARE_MODULE(MusicSongHashIndex)
+public:
+    /*!
+     * Find valid index item by file path, size and last modified time.
+     */
+    bool find(const QString &path, qint64 size, qint64 lastModified, MusicSongHashItem &item);
+    /*!
+     * Insert or update index item by file path.
+     */
+    void insert(const QString &path, const MusicSongHashItem &item);
+    /*!
+     * Remove index item by file path.
+     */
+    void remove(const QString &path);
+    /*!
+     * Remove index items whose file not exist any more.
+     */
+    void purge();
+
+    /*!
+     * Save index items to local file.
+     */
+    bool save();
+
+private:
+    /*!
+     * Object constructor.
+     */
+    MusicSongHashIndex();
+
+    /*!
+     * Load index items from local file.
+     */
+    void load();
+
+    bool m_loaded, m_changed;
+    QMutex m_mutex;
+    QMap<QString, MusicSongHashItem> m_items;
+
+    TTK_DECLARE_SINGLETON_CLASS(MusicSongHashIndex)
+
+};
+
+#define G_SONGHASH_INDEX_PTR makeMusicSongHashIndex()
+TTK_MODULE_EXPORT MusicSongHashIndex* makeMusicSongHashIndex();
+
+#endif // MUSICSONGHASHINDEX_H
@@ -1,4 +1,5 @@
 #include "musicsongmeta.h"
+#include "musicsongmetaindex.h"
 #include "musicformats.h"
 #include "musicstringutils.h"
 #include "ttktime.h"
@@ -31,7 +32,7 @@ MusicSongMeta::~MusicSongMeta() noexcept
     clearSongMeta();
 }
 
-bool MusicSongMeta::read(const QString &url)
+bool MusicSongMeta::read(const QString &url, bool index)
 {
     bool track = false;
     QString path(url);
@@ -55,7 +56,7 @@ bool MusicSongMeta::read(const QString &url)
     }
 
     m_path = path;
-    if(!readInformation())
+    if(!(index && readIndexInformation()) && !readInformation())
     {
         return false;
     }
@@ -342,6 +343,60 @@ QString MusicSongMeta::formatString(TagMeta::Type type) noexcept
 }
 
 
+bool MusicSongMeta::readIndexInformation()
+{
+    MusicSongMetaIndexItem item;
+    if(!G_SONGMETA_INDEX_PTR->find(m_path, item) || item.isEmpty())
+    {
+        return false;
+    }
+
+    clearSongMeta();
+
+    for(const MusicSongMetaIndexTrack &track : qAsConst(item.m_tracks))
+    {
+        MusicMeta *meta = new MusicMeta;
+        meta->m_path = track.m_path;
+
+        for(auto it = track.m_metaData.constBegin(); it != track.m_metaData.constEnd(); ++it)
+        {
+            meta->m_metaData[TTKStaticCast(TagMeta::Type, it.key())] = it.value();
+        }
+
+        m_songMetas << meta;
+        m_offset = m_songMetas.count() - 1;
+    }
+    return !m_songMetas.isEmpty();
+}
+
+void MusicSongMeta::writeIndexInformation()
+{
+    const QFileInfo fin(m_path);
+
+    MusicSongMetaIndexItem item;
+    item.m_size = fin.size();
+    item.m_lastModified = fin.lastModified().toMSecsSinceEpoch();
+
+    for(const MusicMeta *meta : qAsConst(m_songMetas))
+    {
+        MusicSongMetaIndexTrack track;
+        track.m_path = meta->m_path;
+
+        for(auto it = meta->m_metaData.constBegin(); it != meta->m_metaData.constEnd(); ++it)
+        {
+            if(it.key() != TagMeta::DESCRIPTION)
+            {
+                track.m_metaData.insert(it.key(), it.value());
+            }
+        }
+
+        item.m_tracks << track;
+    }
+
+    G_SONGMETA_INDEX_PTR->insert(m_path, item);
+}
+
+
 #ifdef Q_OS_UNIX
 static constexpr const char *SPLITER = "*******************************************************************\n";
 #else
@@ -447,6 +502,7 @@ bool MusicSongMeta::readInformation()
         }
 
         songMeta()->m_metaData[TagMeta::DESCRIPTION] = description;
+        writeIndexInformation();
     }
 
     return !m_songMetas.isEmpty();
@@ -493,5 +549,6 @@ bool MusicSongMeta::saveInformation()
     }
 
     delete model;
+    G_SONGMETA_INDEX_PTR->remove(m_path);
     return true;
 }
@@ -42,8 +42,10 @@ public:
 
     /*!
      * Read music file to anaylsis.
+     * If index is true, try the persistent meta index first and only decode on miss;
+     * cover, lyrics and description are not available from the index.
      */
-    bool read(const QString &url);
+    bool read(const QString &url, bool index = false);
     /*!
      * Save music tags to music file.
      */
@@ -196,6 +198,14 @@ private:
      * Format legal data string.
      */
     QString formatString(TagMeta::Type type) noexcept;
+    /*!
+     * Read other taglib from persistent meta index.
+     */
+    bool readIndexInformation();
+    /*!
+     * Write current taglib into persistent meta index.
+     */
+    void writeIndexInformation();
     /*!
      * Read other taglib not by plugin.
      */
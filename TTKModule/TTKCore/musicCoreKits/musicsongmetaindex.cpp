@@ -0,0 +1,214 @@
+#include "musicsongmetaindex.h"
+
+#include <QDataStream>
+
+#define SONGMETA_INDEX_PATH     APPCACHE_DIR_FULL + "metaindex"
+#define SONGMETA_INDEX_MAGIC    0x544B4D49
+#define SONGMETA_INDEX_VERSION  1
+
+static QDataStream& operator<<(QDataStream &stream, const MusicSongMetaIndexTrack &track)
+{
+    stream << track.m_path << track.m_metaData;
+    return stream;
+}
+
+static QDataStream& operator>>(QDataStream &stream, MusicSongMetaIndexTrack &track)
+{
+    stream >> track.m_path >> track.m_metaData;
+    return stream;
+}
+
+static QDataStream& operator<<(QDataStream &stream, const MusicSongMetaIndexItem &item)
+{
+    stream << item.m_size << item.m_lastModified << item.m_tracks;
+    return stream;
+}
+
+static QDataStream& operator>>(QDataStream &stream, MusicSongMetaIndexItem &item)
+{
+    stream >> item.m_size >> item.m_lastModified >> item.m_tracks;
+    return stream;
+}
+
+
+MusicSongMetaIndex::MusicSongMetaIndex()
+    : m_loaded(false),
+      m_changed(false)
+{
+
+}
+
+bool MusicSongMetaIndex::find(const QString &path, MusicSongMetaIndexItem &item)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        load();
+
+        const auto it = m_items.constFind(path);
+        if(it == m_items.constEnd())
+        {
+            return false;
+        }
+
+        item = it.value();
+    }
+
+    // file system is checked out of the lock, other lookups are not blocked by it
+    return isValid(path, item);
+}
+
+MusicSongMetaIndexItemMap MusicSongMetaIndex::query(const QStringList &paths)
+{
+    MusicSongMetaIndexItemMap items;
+
+    m_mutex.lock();
+    load();
+
+    for(const QString &path : qAsConst(paths))
+    {
+        const auto it = m_items.constFind(path);
+        if(it != m_items.constEnd())
+        {
+            items.insert(path, it.value());
+        }
+    }
+    m_mutex.unlock();
+
+    for(auto it = items.begin(); it != items.end();)
+    {
+        if(!isValid(it.key(), it.value()))
+        {
+            it = items.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return items;
+}
+
+void MusicSongMetaIndex::insert(const QString &path, const MusicSongMetaIndexItem &item)
+{
+    QMutexLocker locker(&m_mutex);
+    load();
+
+    m_items.insert(path, item);
+    m_changed = true;
+}
+
+void MusicSongMetaIndex::remove(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    load();
+
+    m_changed |= m_items.remove(path) > 0;
+}
+
+void MusicSongMetaIndex::purge()
+{
+    m_mutex.lock();
+    load();
+    const QStringList paths = m_items.keys();
+    m_mutex.unlock();
+
+    QStringList missing;
+    for(const QString &path : qAsConst(paths))
+    {
+        if(!QFile::exists(path))
+        {
+            missing << path;
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    for(const QString &path : qAsConst(missing))
+    {
+        m_changed |= m_items.remove(path) > 0;
+    }
+}
+
+void MusicSongMetaIndex::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_items.clear();
+    m_loaded = true;
+    m_changed = true;
+}
+
+int MusicSongMetaIndex::count()
+{
+    QMutexLocker locker(&m_mutex);
+    load();
+    return m_items.count();
+}
+
+bool MusicSongMetaIndex::save()
+{
+    QMutexLocker locker(&m_mutex);
+    if(!m_changed)
+    {
+        return true;
+    }
+
+    QDir().mkpath(APPCACHE_DIR_FULL);
+
+    QFile file(SONGMETA_INDEX_PATH);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        TTK_ERROR_STREAM("Save song meta index file error" << file.fileName());
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream << quint32(SONGMETA_INDEX_MAGIC) << qint32(SONGMETA_INDEX_VERSION) << m_items;
+    file.close();
+
+    m_changed = false;
+    return true;
+}
+
+void MusicSongMetaIndex::load()
+{
+    if(m_loaded)
+    {
+        return;
+    }
+
+    m_loaded = true;
+
+    QFile file(SONGMETA_INDEX_PATH);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    quint32 magic = 0;
+    qint32 version = 0;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream >> magic >> version;
+
+    if(magic != SONGMETA_INDEX_MAGIC || version != SONGMETA_INDEX_VERSION)
+    {
+        TTK_WARN_STREAM("Song meta index file version mismatch, index will be rebuilt");
+        file.close();
+        return;
+    }
+
+    stream >> m_items;
+    if(stream.status() != QDataStream::Ok)
+    {
+        TTK_WARN_STREAM("Song meta index file is corrupted, index will be rebuilt");
+        m_items.clear();
+    }
+    file.close();
+}
+
+bool MusicSongMetaIndex::isValid(const QString &path, const MusicSongMetaIndexItem &item)
+{
+    const QFileInfo fin(path);
+    return fin.exists() && fin.size() == item.m_size && fin.lastModified().toMSecsSinceEpoch() == item.m_lastModified;
+}
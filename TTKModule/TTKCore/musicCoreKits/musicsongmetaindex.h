@@ -0,0 +1,131 @@
+#ifndef MUSICSONGMETAINDEX_H
+#define MUSICSONGMETAINDEX_H
+
+/***************************************************************************
+ * This file is part of the TTK Music Player project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <QMutex>
+#include "musicobject.h"
+#include "ttksingleton.h"
+
+/*! @brief The class of the music song meta index track.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct TTK_MODULE_EXPORT MusicSongMetaIndexTrack
+{
+    QString m_path;
+    QMap<int, QString> m_metaData;
+};
+TTK_DECLARE_LIST(MusicSongMetaIndexTrack);
+
+
+/*! @brief The class of the music song meta index item.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct TTK_MODULE_EXPORT MusicSongMetaIndexItem
+{
+    qint64 m_size;
+    qint64 m_lastModified;
+    MusicSongMetaIndexTrackList m_tracks;
+
+    MusicSongMetaIndexItem() noexcept
+        : m_size(-1),
+          m_lastModified(-1)
+    {
+
+    }
+
+    inline bool isEmpty() const noexcept
+    {
+        return m_tracks.isEmpty();
+    }
+};
+TTK_DECLARE_LIST(MusicSongMetaIndexItem);
+using MusicSongMetaIndexItemMap = QMap<QString, MusicSongMetaIndexItem>;
+
+
+/*! @brief The class of the music song meta persistent index.
+ * Entries are keyed by file path and validated by file size and last modified time.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicSongMetaIndex
+{
+    TTK_DECLARE_MODULE(MusicSongMetaIndex)
+public:
+    /*!
+     * Find valid index item by file path.
+     */
+    bool find(const QString &path, MusicSongMetaIndexItem &item);
+    /*!
+     * Query valid index items by file paths, stale or missing entries are skipped.
+     */
+    MusicSongMetaIndexItemMap query(const QStringList &paths);
+
+    /*!
+     * Insert or update index item by file path.
+     */
+    void insert(const QString &path, const MusicSongMetaIndexItem &item);
+    /*!
+     * Remove index item by file path.
+     */
+    void remove(const QString &path);
+    /*!
+     * Remove index items whose file not exist any more.
+     */
+    void purge();
+    /*!
+     * Clear all index items.
+     */
+    void clear();
+    /*!
+     * Get index item count.
+     */
+    int count();
+
+    /*!
+     * Save index items to local file.
+     */
+    bool save();
+
+private:
+    /*!
+     * Object constructor.
+     */
+    MusicSongMetaIndex();
+
+    /*!
+     * Load index items from local file.
+     */
+    void load();
+    /*!
+     * Check index item is still valid for current file.
+     */
+    static bool isValid(const QString &path, const MusicSongMetaIndexItem &item);
+
+    bool m_loaded, m_changed;
+    QMutex m_mutex;
+    MusicSongMetaIndexItemMap m_items;
+
+    TTK_DECLARE_SINGLETON_CLASS(MusicSongMetaIndex)
+
+};
+
+#define G_SONGMETA_INDEX_PTR makeMusicSongMetaIndex()
+TTK_MODULE_EXPORT MusicSongMetaIndex* makeMusicSongMetaIndex();
+
+#endif // MUSICSONGMETAINDEX_H
@@ -3,12 +3,11 @@
 #include "musicapplication.h"
 #include "ttktime.h"
 
-#include <qmath.h>
-
 MusicLrcAnalysis::MusicLrcAnalysis(QObject *parent)
     : QObject(parent),
       m_lineMax(0),
-      m_currentLrcIndex(0)
+      m_currentLrcIndex(0),
+      m_cursor(0)
 {
 
 }
@@ -34,10 +33,7 @@ MusicLrcAnalysis::State MusicLrcAnalysis::setData(const QByteArray &data)
     }
     else
     {
-        for(const QString &oneLine : qAsConst(text))
-        {
-            matchLrcLine(oneLine);
-        }
+        matchLrcData(text);
     }
 
     if(m_lrcContainer.isEmpty())
@@ -45,26 +41,7 @@ MusicLrcAnalysis::State MusicLrcAnalysis::setData(const QByteArray &data)
         return State::Failed;
     }
 
-    for(int i = 0; i < lineMiddle(); ++i)
-    {
-        m_currentShowLrcContainer << QString();
-    }
-
-    if(m_lrcContainer.find(0) == m_lrcContainer.end())
-    {
-        m_lrcContainer.insert(0, {});
-    }
-
-    for(auto it = m_lrcContainer.constBegin(); it != m_lrcContainer.constEnd(); ++it)
-    {
-        m_currentShowLrcContainer << it.value();
-    }
-
-    for(int i = 0; i < lineMiddle(); ++i)
-    {
-        m_currentShowLrcContainer << QString();
-    }
-
+    updateContainer();
     return State::Success;
 }
 
@@ -78,26 +55,7 @@ MusicLrcAnalysis::State MusicLrcAnalysis::setData(const TTKIntStringMap &data)
 
     m_lrcContainer = data;
 
-    for(int i = 0; i < lineMiddle(); ++i)
-    {
-        m_currentShowLrcContainer << QString();
-    }
-
-    if(m_lrcContainer.find(0) == m_lrcContainer.end())
-    {
-        m_lrcContainer.insert(0, {});
-    }
-
-    for(auto it = m_lrcContainer.constBegin(); it != m_lrcContainer.constEnd(); ++it)
-    {
-        m_currentShowLrcContainer << it.value();
-    }
-
-    for(int i = 0; i < lineMiddle(); ++i)
-    {
-        m_currentShowLrcContainer << QString();
-    }
-
+    updateContainer();
     return State::Success;
 }
 
@@ -130,10 +88,7 @@ MusicLrcAnalysis::State MusicLrcAnalysis::loadFromKrcFile(const QString &path)
 
     const QString &text = QString(krc.decodeString());
     //The lyrics by line into the lyrics list
-    for(const QString &oneLine : text.split(TTK_WLINEFEED))
-    {
-        matchLrcLine(oneLine);
-    }
+    matchLrcData(text.split(TTK_WLINEFEED));
 
     //If the lrcContainer is empty
     if(m_lrcContainer.isEmpty())
@@ -141,232 +96,206 @@ MusicLrcAnalysis::State MusicLrcAnalysis::loadFromKrcFile(const QString &path)
         return State::Failed;
     }
 
-    for(int i = 0; i < lineMiddle(); ++i)
-    {
-        m_currentShowLrcContainer << QString();
-    }
-
-    if(m_lrcContainer.find(0) == m_lrcContainer.end())
-    {
-        m_lrcContainer.insert(0, {});
-    }
-
-    for(auto it = m_lrcContainer.constBegin(); it != m_lrcContainer.constEnd(); ++it)
-    {
-        m_currentShowLrcContainer << it.value();
-    }
-
-    for(int i = 0; i < lineMiddle(); ++i)
-    {
-        m_currentShowLrcContainer << QString();
-    }
-
+    updateContainer();
     return State::Success;
 }
 
-void MusicLrcAnalysis::matchLrcLine(const QString &oneLine)
+static inline bool isDigit(const QChar &c)
 {
-    const QRegExp regx01("\\[\\d{2}:\\d{2}\\.\\d{3}\\]");
-    const QRegExp regx02("\\[\\d{2}:\\d{2}\\.\\d{2}\\]");
-    const QRegExp regx03("\\[\\d{2}:\\d{2}\\.\\d{1}\\]");
-    const QRegExp regx04("\\[\\d{2}:\\d{2}:\\d{3}\\]");
-    const QRegExp regx05("\\[\\d{2}:\\d{2}:\\d{2}\\]");
-    const QRegExp regx06("\\[\\d{2}:\\d{2}:\\d{1}\\]");
-    const QRegExp regx07("\\[\\d{2}:\\d{2}\\]");
-    const QRegExp regx08("\\[\\d{2}\\.\\d{2}\\.\\d{3}\\]");
-    const QRegExp regx09("\\[\\d{2}\\.\\d{2}\\.\\d{2}\\]");
-    const QRegExp regx10("\\[\\d{2}\\.\\d{2}\\.\\d{1}\\]");
-    const QRegExp regx11("\\[\\d{2}\\.\\d{2}:\\d{3}\\]");
-    const QRegExp regx12("\\[\\d{2}\\.\\d{2}:\\d{2}\\]");
-    const QRegExp regx13("\\[\\d{2}\\.\\d{2}:\\d{1}\\]");
-    const QRegExp regx14("\\[\\d{2}\\.\\d{2}\\]");
+    return c.unicode() >= '0' && c.unicode() <= '9';
+}
 
-    Format type = Format::Type02;
-    QRegExp regx;
-    if(oneLine.contains(regx01))
-    {
-        type = Format::Type01;
-        regx = regx01;
-    }
-    else if(oneLine.contains(regx02))
-    {
-        type = Format::Type02;
-        regx = regx02;
-    }
-    else if(oneLine.contains(regx03))
-    {
-        type = Format::Type03;
-        regx = regx03;
-    }
-    else if(oneLine.contains(regx04))
+static inline int toDigit(const QChar &c)
+{
+    return c.unicode() - '0';
+}
+
+/*!
+ * Parse one time tag [mm(:.)ss((:.)x{1,3})] at pos, return tag length or zero if it is not a time tag.
+ */
+static int parseTimeTag(const QString &line, int pos, MusicLrcAnalysis::Format &type, qint64 &time)
+{
+    const QChar *data = line.constData() + pos;
+    const int length = line.length() - pos;
+    //The shortest tag [xx:xx] has seven chars
+    if(length < 7 || data[0] != QChar('[') || !isDigit(data[1]) || !isDigit(data[2]) || !isDigit(data[4]) || !isDigit(data[5]))
     {
-        type = Format::Type04;
-        regx = regx04;
+        return 0;
     }
-    else if(oneLine.contains(regx05))
+
+    const QChar first = data[3];
+    if(first != QChar(':') && first != QChar('.'))
     {
-        type = Format::Type05;
-        regx = regx05;
+        return 0;
     }
-    else if(oneLine.contains(regx06))
+
+    time = (toDigit(data[1]) * 10 + toDigit(data[2])) * TTK_DN_M2MS + (toDigit(data[4]) * 10 + toDigit(data[5])) * TTK_DN_S2MS;
+    if(data[6] == QChar(']'))
     {
-        type = Format::Type06;
-        regx = regx06;
+        type = first == QChar(':') ? MusicLrcAnalysis::Format::Type07 : MusicLrcAnalysis::Format::Type14;
+        return 7;
     }
-    else if(oneLine.contains(regx07))
+
+    const QChar second = data[6];
+    if(second != QChar(':') && second != QChar('.'))
     {
-        type = Format::Type07;
-        regx = regx07;
+        return 0;
     }
-    else if(oneLine.contains(regx08))
+
+    int count = 0;
+    int milliseconds = 0;
+    while(count < 3 && 7 + count < length && isDigit(data[7 + count]))
     {
-        type = Format::Type08;
-        regx = regx08;
+        milliseconds = milliseconds * 10 + toDigit(data[7 + count]);
+        ++count;
     }
-    else if(oneLine.contains(regx09))
+
+    if(count == 0 || 7 + count >= length || data[7 + count] != QChar(']'))
     {
-        type = Format::Type09;
-        regx = regx09;
+        return 0;
     }
-    else if(oneLine.contains(regx10))
+
+    for(int i = count; i < 3; ++i)
     {
-        type = Format::Type10;
-        regx = regx10;
+        milliseconds *= 10;
     }
-    else if(oneLine.contains(regx11))
+    time += milliseconds;
+
+    MusicLrcAnalysis::Format base = MusicLrcAnalysis::Format::Type01;
+    if(first == QChar(':'))
     {
-        type = Format::Type11;
-        regx = regx11;
+        base = second == QChar('.') ? MusicLrcAnalysis::Format::Type01 : MusicLrcAnalysis::Format::Type04;
     }
-    else if(oneLine.contains(regx12))
+    else
     {
-        type = Format::Type12;
-        regx = regx12;
+        base = second == QChar('.') ? MusicLrcAnalysis::Format::Type08 : MusicLrcAnalysis::Format::Type11;
     }
-    else if(oneLine.contains(regx13))
+
+    type = MusicLrcAnalysis::Format(TTKStaticCast(int, base) + 3 - count);
+    return 8 + count;
+}
+
+/*!
+ * Parse offset tag [offset:+/-xxx], return true if it is an offset tag.
+ */
+static bool parseOffsetTag(const QString &line, qint64 &offset)
+{
+    const QString &v = line.trimmed();
+    if(!v.startsWith("[offset:", Qt::CaseInsensitive) || !v.endsWith(']'))
     {
-        type = Format::Type13;
-        regx = regx13;
+        return false;
     }
-    else
+
+    bool ok = false;
+    const qint64 value = v.mid(8, v.length() - 9).trimmed().toLongLong(&ok);
+    if(ok)
     {
-        type = Format::Type14;
-        regx = regx14;
+        offset = value;
     }
+    return ok;
+}
 
-    QString temp = oneLine;
-    temp.replace(regx, {});
-    int pos = regx.indexIn(oneLine);
-    while(pos != -1)
+void MusicLrcAnalysis::matchLrcData(const QStringList &lines)
+{
+    qint64 offset = 0;
+    for(const QString &oneLine : qAsConst(lines))
     {
-        const QString &cap = regx.cap(0);
-        //Return zeroth expression matching the content
-        //The time tag into the time value, in milliseconds
-        switch(type)
+        if(!parseOffsetTag(oneLine, offset))
         {
-            case Format::Type01: matchLrcLine(temp, cap, "\\d{2}(?=:)", "\\d{2}(?=\\.)", "\\d{3}(?=\\])"); break;
-            case Format::Type02: matchLrcLine(temp, cap, "\\d{2}(?=:)", "\\d{2}(?=\\.)", "\\d{2}(?=\\])"); break;
-            case Format::Type03: matchLrcLine(temp, cap, "\\d{2}(?=:)", "\\d{2}(?=\\.)", "\\d{1}(?=\\])"); break;
-            case Format::Type04: matchLrcLine(temp, cap, ":"); break;
-            case Format::Type05: matchLrcLine(temp, cap, ":"); break;
-            case Format::Type06: matchLrcLine(temp, cap, ":"); break;
-            case Format::Type07: matchLrcLine(temp, cap, "\\d{2}(?=:)", "\\d{2}(?=\\])"); break;
-            case Format::Type08: matchLrcLine(temp, cap, "."); break;
-            case Format::Type09: matchLrcLine(temp, cap, "."); break;
-            case Format::Type10: matchLrcLine(temp, cap, "."); break;
-            case Format::Type11: matchLrcLine(temp, cap, "\\d{2}(?=\\.)", "\\d{2}(?=:)", "\\d{3}(?=\\])"); break;
-            case Format::Type12: matchLrcLine(temp, cap, "\\d{2}(?=\\.)", "\\d{2}(?=:)", "\\d{2}(?=\\])"); break;
-            case Format::Type13: matchLrcLine(temp, cap, "\\d{2}(?=\\.)", "\\d{2}(?=:)", "\\d{1}(?=\\])"); break;
-            case Format::Type14: matchLrcLine(temp, cap, "\\d{2}(?=\\.)", "\\d{2}(?=\\])"); break;
-            default: break;
+            matchLrcLine(oneLine);
         }
+    }
 
-        pos += regx.matchedLength();
-        pos = regx.indexIn(oneLine, pos); //Matching all
+    //Positive offset shows lyrics earlier
+    if(offset != 0)
+    {
+        revertTime(-offset);
     }
 }
 
-void MusicLrcAnalysis::matchLrcLine(const QString &oneLine, const QString &cap, const QString &first, const QString &second, const QString &third)
+void MusicLrcAnalysis::matchLrcLine(const QString &oneLine)
 {
-    QRegExp regx;
-    regx.setPattern(first);
-    regx.indexIn(cap);
-
-    const int minutes = regx.cap(0).toInt();
-    regx.setPattern(second);
-    regx.indexIn(cap);
-
-    const int seconds = regx.cap(0).toInt();
-    regx.setPattern(third);
-    regx.indexIn(cap);
-
-    const int milliseconds = regx.cap(0).toInt();
-    const int length = QString::number(milliseconds).length();
-    const qint64 totalTime = minutes * TTK_DN_M2MS + seconds * TTK_DN_S2MS + milliseconds * pow(10, 3 - length);
-    m_lrcContainer.insert(totalTime, oneLine);
-}
+    struct TimeTag
+    {
+        int m_pos;
+        int m_length;
+        Format m_type;
+        qint64 m_time;
+    };
 
-void MusicLrcAnalysis::matchLrcLine(const QString &oneLine, const QString &cap, const QString &first, const QString &second)
-{
-    QRegExp regx;
-    regx.setPattern(first);
-    regx.indexIn(cap);
+    //Tokenize all time tags by single pass, the line is matched by the most precise format it contains
+    QVector<TimeTag> tags;
+    Format type = Format::Type14;
+    for(int pos = oneLine.indexOf('['); pos != -1;)
+    {
+        TimeTag tag;
+        tag.m_pos = pos;
+        tag.m_length = parseTimeTag(oneLine, pos, tag.m_type, tag.m_time);
 
-    const int minutes = regx.cap(0).toInt();
-    regx.setPattern(second);
-    regx.indexIn(cap);
+        if(tag.m_length > 0)
+        {
+            if(tags.isEmpty() || tag.m_type < type)
+            {
+                type = tag.m_type;
+            }
 
-    const int seconds = regx.cap(0).toInt();
-    const qint64 totalTime = minutes * TTK_DN_M2MS + seconds * TTK_DN_S2MS;
-    m_lrcContainer.insert(totalTime, oneLine);
-}
+            tags << tag;
+            pos = oneLine.indexOf('[', pos + tag.m_length);
+        }
+        else
+        {
+            pos = oneLine.indexOf('[', pos + 1);
+        }
+    }
 
-void MusicLrcAnalysis::matchLrcLine(const QString &oneLine, QString cap, const QString &splite)
-{
-    cap.chop(1);
-    cap.remove(0, 1);
-    const QStringList list(cap.split(splite));
-    if(list.count() != 3)
+    if(tags.isEmpty())
     {
         return;
     }
 
-    const int minutes = list[0].toInt();
-    const int seconds = list[1].toInt();
-    const int milliseconds = list[2].toInt();
-    const int length = QString::number(milliseconds).length();
-    const qint64 totalTime = minutes * TTK_DN_M2MS + seconds * TTK_DN_S2MS + milliseconds * pow(10, 3 - length);
-    m_lrcContainer.insert(totalTime, oneLine);
-}
-
-qint64 MusicLrcAnalysis::setSongTimeSpeed(qint64 time)
-{
-    const QList<qint64> keys(m_lrcContainer.keys());
-    qint64 beforeTime = 0;
-    int index = -1;
-
-    if(!keys.isEmpty())
+    QString text;
+    int last = 0;
+    for(const TimeTag &tag : qAsConst(tags))
     {
-        index = 0;
-        beforeTime = keys[0];
+        if(tag.m_type == type)
+        {
+            text.append(oneLine.mid(last, tag.m_pos - last));
+            last = tag.m_pos + tag.m_length;
+        }
     }
+    text.append(oneLine.mid(last));
 
-    for(int i = 1; i < keys.count(); ++i)
+    for(const TimeTag &tag : qAsConst(tags))
     {
-        index = i;
-        const qint64 afterTime = keys[i];
-        if(beforeTime <= time && time <= afterTime)
+        if(tag.m_type == type)
         {
-            time = afterTime;
-            break;
+            m_lrcContainer.insert(tag.m_time, text);
         }
-        beforeTime = afterTime;
     }
+}
 
-    if((m_currentLrcIndex = index - 1) < 0)
+qint64 MusicLrcAnalysis::setSongTimeSpeed(qint64 time)
+{
+    const int count = m_lrcTimes.count();
+    if(count < 2)
     {
         m_currentLrcIndex = 0;
+        return time;
     }
+
+    //Find the first lrc time not before given time
+    int index = std::lower_bound(m_lrcTimes.constBegin() + 1, m_lrcTimes.constEnd(), time) - m_lrcTimes.constBegin();
+    if(index >= count)
+    {
+        index = count - 1;
+    }
+    else
+    {
+        time = m_lrcTimes[index];
+    }
+
+    m_cursor = index - 1;
+    m_currentLrcIndex = qMax(0, index - 1);
     return time;
 }
 
@@ -378,6 +307,11 @@ void MusicLrcAnalysis::revertTime(qint64 pos)
         copy.insert(it.key() + pos, it.value());
     }
     m_lrcContainer = copy;
+
+    for(qint64 &time : m_lrcTimes)
+    {
+        time += pos;
+    }
 }
 
 void MusicLrcAnalysis::saveData()
@@ -407,7 +341,10 @@ void MusicLrcAnalysis::saveData()
 void MusicLrcAnalysis::clear()
 {
     m_currentLrcIndex = 0;
+    m_cursor = 0;
     m_lrcContainer.clear();
+    m_lrcTimes.clear();
+    m_lrcTexts.clear();
     m_currentShowLrcContainer.clear();
 }
 
@@ -452,47 +389,37 @@ bool MusicLrcAnalysis::findText(qint64 current, qint64 total, QString &pre, QStr
     }
 
     //After get the current time in the lyrics of the two time points
-    qint64 previous = 0;
-    qint64 later = 0;
-    //Keys () method returns a list of lrcContainer
-    for(const qint64 value : m_lrcContainer.keys())
-    {
-        if(current >= value)
-        {
-            previous = value;
-        }
-        else
-        {
-            later = value;
-            break;
-        }
-    }
+    const int index = findIndex(current);
+    const qint64 previous = index < 0 ? 0 : m_lrcTimes[index];
     //To the last line, set the later to song total time value
-    if(later == 0)
-    {
-        later = total;
-    }
+    const bool end = index + 1 >= m_lrcTimes.count();
+    const qint64 later = end ? total : m_lrcTimes[index + 1];
+
     //The lyrics content corresponds to obtain the current time
-    pre = m_lrcContainer.value(previous);
-    last = m_lrcContainer.value(later);
+    pre = index < 0 ? QString() : m_lrcTexts[index];
+    last = end ? QString() : m_lrcTexts[index + 1];
     interval = later - previous;
 
     return true;
 }
 
+qint64 MusicLrcAnalysis::findElapsed(qint64 current) const
+{
+    if(isEmpty())
+    {
+        return -1;
+    }
+
+    const int index = findIndex(current);
+    return index < 0 ? -1 : current - m_lrcTimes[index];
+}
+
 qint64 MusicLrcAnalysis::findTime(int index) const
 {
     if(index + m_lineMax < m_currentShowLrcContainer.count())
     {
-        auto it = m_lrcContainer.constBegin();
-        for(int i = 0; i < index + 1; ++i)
-        {
-            if(it != m_lrcContainer.constEnd())
-            {
-                ++it;
-            }
-        }
-        return it.key();
+        ++index;
+        return (index < m_lrcTimes.count()) ? m_lrcTimes[index] : -1;
     }
     else
     {
@@ -507,9 +434,21 @@ qint64 MusicLrcAnalysis::findTime(const QStringList &ts) const
         return -1;
     }
 
-    for(int i = 0; i < m_currentShowLrcContainer.count() - ts.count(); ++i)
+    const int count = ts.count();
+    for(int i = 0; i < m_currentShowLrcContainer.count() - count; ++i)
     {
-        if(m_currentShowLrcContainer.mid(i, ts.count()) == ts)
+        if(m_currentShowLrcContainer[i] != ts[0])
+        {
+            continue;
+        }
+
+        int j = 1;
+        while(j < count && m_currentShowLrcContainer[i + j] == ts[j])
+        {
+            ++j;
+        }
+
+        if(j == count)
         {
             return findTime(i + lineMiddle());
         }
@@ -520,7 +459,7 @@ qint64 MusicLrcAnalysis::findTime(const QStringList &ts) const
 QString MusicLrcAnalysis::dataString() const
 {
     QString v;
-    for(const QString &s : m_lrcContainer.values())
+    for(const QString &s : qAsConst(m_lrcTexts))
     {
         v.append(s + TTK_LINEFEED);
     }
@@ -529,5 +468,58 @@ QString MusicLrcAnalysis::dataString() const
 
 QStringList MusicLrcAnalysis::dataList() const
 {
-    return m_lrcContainer.values();
+    return m_lrcTexts;
+}
+
+void MusicLrcAnalysis::updateContainer()
+{
+    if(m_lrcContainer.find(0) == m_lrcContainer.end())
+    {
+        m_lrcContainer.insert(0, {});
+    }
+
+    m_cursor = 0;
+    m_lrcTimes.clear();
+    m_lrcTexts.clear();
+    m_currentShowLrcContainer.clear();
+
+    m_lrcTimes.reserve(m_lrcContainer.count());
+    for(int i = 0; i < lineMiddle(); ++i)
+    {
+        m_currentShowLrcContainer << QString();
+    }
+
+    for(auto it = m_lrcContainer.constBegin(); it != m_lrcContainer.constEnd(); ++it)
+    {
+        m_lrcTimes << it.key();
+        m_lrcTexts << it.value();
+        m_currentShowLrcContainer << it.value();
+    }
+
+    for(int i = 0; i < lineMiddle(); ++i)
+    {
+        m_currentShowLrcContainer << QString();
+    }
+}
+
+int MusicLrcAnalysis::findIndex(qint64 time) const
+{
+    const int count = m_lrcTimes.count();
+    //Forward playing almost always stays at or moves to the next line
+    for(int i = m_cursor; i >= 0 && i < count && i <= m_cursor + 1; ++i)
+    {
+        if(m_lrcTimes[i] <= time && (i + 1 >= count || time < m_lrcTimes[i + 1]))
+        {
+            return m_cursor = i;
+        }
+    }
+
+    //Find the last lrc time not after given time
+    m_cursor = std::upper_bound(m_lrcTimes.constBegin(), m_lrcTimes.constEnd(), time) - m_lrcTimes.constBegin() - 1;
+    if(m_cursor < 0)
+    {
+        m_cursor = 0;
+        return -1;
+    }
+    return m_cursor;
 }
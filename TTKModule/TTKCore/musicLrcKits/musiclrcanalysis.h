@@ -151,6 +151,10 @@ public:
      * Get current lrc and next lrc in container by current time.
      */
     bool findText(qint64 current, qint64 total, QString &pre, QString &last, qint64 &interval) const;
+    /*!
+     * Get elapsed time of current lrc line by current time, -1 means no line.
+     */
+    qint64 findElapsed(qint64 current) const;
     /*!
      * Get current time by index.
      */
@@ -171,25 +175,28 @@ public:
 
 private:
     /*!
-     * Lrc analysis by match lrc line base.
+     * Lrc analysis by match all lrc lines and offset tag.
      */
-    void matchLrcLine(const QString &oneLine);
+    void matchLrcData(const QStringList &lines);
     /*!
-     * Lrc analysis by match lrc line two[xx.(:)xx].
+     * Lrc analysis by match lrc line time tags.
      */
-    void matchLrcLine(const QString &oneLine, const QString &cap, const QString &first, const QString &second);
+    void matchLrcLine(const QString &oneLine);
     /*!
-     * Lrc analysis by match lrc line three[xx.xx.x(xx)]\[xx:xx:x(xx)].
+     * Update sorted time and text arrays from container.
      */
-    void matchLrcLine(const QString &oneLine, QString cap, const QString &splite);
+    void updateContainer();
     /*!
-     * Lrc analysis by match lrc line three[xx.(:)xx.(:)x(xx)].
+     * Find the last lrc index whose time is not after given time, -1 if none.
      */
-    void matchLrcLine(const QString &oneLine, const QString &cap, const QString &first, const QString &second, const QString &third);
+    int findIndex(qint64 time) const;
 
     int m_lineMax, m_currentLrcIndex;
+    mutable int m_cursor;
     QString m_currentFilePath;
     TTKIntStringMap m_lrcContainer;
+    QVector<qint64> m_lrcTimes;
+    QStringList m_lrcTexts;
     QStringList m_currentShowLrcContainer;
 
 };
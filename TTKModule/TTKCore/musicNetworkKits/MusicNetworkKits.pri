@@ -38,6 +38,7 @@ HEADERS += \
     $$PWD/core/musicabstractnetwork.h \
     $$PWD/core/musicabstractdownloadrequest.h \
     $$PWD/core/musicpagequeryrequest.h \
+    $$PWD/core/musicquerybatchrequest.h \
     $$PWD/image/background/musicabstractdownloadimagerequest.h \
     $$PWD/image/background/musicdownloadbackgroundrequest.h \
     $$PWD/image/background/musicbpdownloadimagerequest.h \
@@ -136,6 +137,7 @@ SOURCES += \
     $$PWD/core/musicabstractnetwork.cpp \
     $$PWD/core/musicabstractdownloadrequest.cpp \
     $$PWD/core/musicpagequeryrequest.cpp \
+    $$PWD/core/musicquerybatchrequest.cpp \
     $$PWD/image/background/musicabstractdownloadimagerequest.cpp \
     $$PWD/image/background/musicdownloadbackgroundrequest.cpp \
     $$PWD/image/background/musicbpdownloadimagerequest.cpp \
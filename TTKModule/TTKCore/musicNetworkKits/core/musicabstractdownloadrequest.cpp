@@ -55,7 +55,7 @@ void MusicAbstractDownLoadRequest::updateDownloadSpeed()
 {
     const int delta = m_currentReceived - m_hasReceived;
     ///limit speed
-    if(G_SETTING_PTR->value(MusicSettingManager::DownloadLimitEnable).toInt() == 0)
+    if(G_SETTING_PTR->value<MusicSettingManager::DownloadLimitEnable>() == 0)
     {
         const int limitValue = G_SETTING_PTR->value(MusicSettingManager::DownloadDownloadLimitSize).toInt();
         if(limitValue != 0 && delta > limitValue * TTK_SN_KB2B)
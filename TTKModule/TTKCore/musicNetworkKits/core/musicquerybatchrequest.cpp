@@ -0,0 +1,124 @@
+#include "musicquerybatchrequest.h"
+
+MusicQueryBatchRequest::MusicQueryBatchRequest(QObject *parent)
+    : QObject(parent),
+      m_parallelCount(QUERY_BATCH_PARALLEL_COUNT),
+      m_current(0),
+      m_finished(0),
+      m_loop(nullptr)
+{
+
+}
+
+MusicQueryBatchRequest::~MusicQueryBatchRequest()
+{
+    abort();
+}
+
+void MusicQueryBatchRequest::setMaxParallelCount(int count)
+{
+    m_parallelCount = qMax(1, count);
+}
+
+void MusicQueryBatchRequest::addRequest(const QNetworkRequest &request, TTK::MusicSongInformation *info, Parser parser)
+{
+    Item item;
+    item.m_request = request;
+    item.m_info = info;
+    item.m_parser = parser;
+    m_items << item;
+}
+
+void MusicQueryBatchRequest::exec()
+{
+    if(m_items.isEmpty())
+    {
+        return;
+    }
+
+    m_current = 0;
+    m_finished = 0;
+
+    TTKSemaphoreLoop loop;
+    m_loop = &loop;
+
+    const int count = qMin(m_parallelCount, m_items.count());
+    for(int i = 0; i < count; ++i)
+    {
+        startNext();
+    }
+
+    loop.exec();
+    m_loop = nullptr;
+    //drop the requests still in flight when time out
+    abort();
+}
+
+void MusicQueryBatchRequest::abort()
+{
+    m_current = m_items.count();
+
+    const QList<QNetworkReply*> replies(m_replies.keys());
+    m_replies.clear();
+
+    for(QNetworkReply *reply : qAsConst(replies))
+    {
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
+void MusicQueryBatchRequest::replyFinished()
+{
+    QNetworkReply *reply = TTKObjectCast(QNetworkReply*, sender());
+    if(!reply || !m_replies.contains(reply))
+    {
+        return;
+    }
+
+    const int index = m_replies.take(reply);
+    if(reply->error() == QNetworkReply::NoError)
+    {
+        const QByteArray &bytes = reply->readAll();
+        const Item &item = m_items[index];
+        if(!bytes.isEmpty() && item.m_parser)
+        {
+            item.m_parser(item.m_info, bytes);
+        }
+    }
+    else
+    {
+        TTK_INFO_STREAM(reply->error() << reply->errorString());
+    }
+    reply->deleteLater();
+
+    if(++m_finished >= m_items.count())
+    {
+        if(m_loop)
+        {
+            m_loop->quit();
+        }
+        return;
+    }
+
+    //time out counts from the last completed reply, not from the batch start
+    if(m_loop)
+    {
+        m_loop->restart();
+    }
+    startNext();
+}
+
+void MusicQueryBatchRequest::startNext()
+{
+    if(m_current >= m_items.count())
+    {
+        return;
+    }
+
+    const int index = m_current++;
+    QNetworkReply *reply = m_manager.get(m_items[index].m_request);
+    m_replies.insert(reply, index);
+    connect(reply, SIGNAL(finished()), SLOT(replyFinished()));
+}
@@ -0,0 +1,98 @@
+#ifndef MUSICQUERYBATCHREQUEST_H
+#define MUSICQUERYBATCHREQUEST_H
+
+/***************************************************************************
+ * This file is part of the TTK Music Player project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "ttksemaphoreloop.h"
+#include "musicabstractnetwork.h"
+
+static constexpr int QUERY_BATCH_PARALLEL_COUNT = 6;
+
+/*! @brief The class of the query detail batch request.
+ * Detail requests are issued concurrently with a parallelism cap,
+ * each result is parsed as soon as its reply arrives.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicQueryBatchRequest : public QObject
+{
+    Q_OBJECT
+    TTK_DECLARE_MODULE(MusicQueryBatchRequest)
+public:
+    using Parser = void(*)(TTK::MusicSongInformation *info, const QByteArray &bytes);
+
+    /*!
+     * Object constructor.
+     */
+    explicit MusicQueryBatchRequest(QObject *parent = nullptr);
+    /*!
+     * Object destructor.
+     */
+    ~MusicQueryBatchRequest();
+
+    /*!
+     * Set max count of requests in flight.
+     */
+    void setMaxParallelCount(int count);
+    /*!
+     * Add detail request, the parser fills info with reply data.
+     */
+    void addRequest(const QNetworkRequest &request, TTK::MusicSongInformation *info, Parser parser);
+    /*!
+     * Get detail requests count.
+     */
+    inline int count() const { return m_items.count(); }
+
+    /*!
+     * Start all requests and wait until all finished or time out.
+     */
+    void exec();
+    /*!
+     * Abort all requests in flight.
+     */
+    void abort();
+
+private Q_SLOTS:
+    /*!
+     * Detail request reply finished.
+     */
+    void replyFinished();
+
+private:
+    /*!
+     * Start the next pending request.
+     */
+    void startNext();
+
+    struct Item
+    {
+        QNetworkRequest m_request;
+        TTK::MusicSongInformation *m_info;
+        Parser m_parser;
+    };
+
+    int m_parallelCount;
+    int m_current, m_finished;
+    QList<Item> m_items;
+    QHash<QNetworkReply*, int> m_replies;
+    QNetworkAccessManager m_manager;
+    TTKSemaphoreLoop *m_loop;
+
+};
+
+#endif // MUSICQUERYBATCHREQUEST_H
@@ -1,4 +1,5 @@
 #include "musickgqueryalbumrequest.h"
+#include "musicquerybatchrequest.h"
 
 MusicKGQueryAlbumRequest::MusicKGQueryAlbumRequest(QObject *parent)
     : MusicQueryAlbumRequest(parent)
@@ -56,6 +57,8 @@ void MusicKGQueryAlbumRequest::downLoadFinished()
                 value = value["data"].toMap();
                 m_totalSize = value["total"].toInt();
 
+                TTK::MusicSongInformationList items;
+                QStringList albums;
                 const QVariantList &datas = value["info"].toList();
                 for(const QVariant &var : qAsConst(datas))
                 {
@@ -76,18 +79,35 @@ void MusicKGQueryAlbumRequest::downLoadFinished()
                     info.m_year.clear();
                     info.m_trackNumber = "0";
 
-                    TTK_NETWORK_QUERY_CHECK();
-                    ReqKGInterface::parseFromSongAlbumLrc(&info);
-                    TTK_NETWORK_QUERY_CHECK();
                     ReqKGInterface::parseFromSongProperty(&info, value);
-                    TTK_NETWORK_QUERY_CHECK();
+                    items << info;
+                    albums << value["album_audio_id"].toString();
+                }
 
+                //Query all detail tags concurrently, instead of one blocking request per result
+                MusicQueryBatchRequest batch;
+                for(TTK::MusicSongInformation &info : items)
+                {
+                    QNetworkRequest request;
+                    if(ReqKGInterface::makeSongAlbumLrcRequest(&info, &request))
+                    {
+                        batch.addRequest(request, &info, ReqKGInterface::parseFromSongAlbumLrc);
+                    }
+                }
+
+                TTK_NETWORK_QUERY_CHECK();
+                batch.exec();
+                TTK_NETWORK_QUERY_CHECK();
+
+                for(int i = 0; i < items.count(); ++i)
+                {
+                    TTK::MusicSongInformation &info = items[i];
                     if(!m_albumFound)
                     {
                         m_albumFound = true;
                         MusicResultDataItem item;
                         TTK_NETWORK_QUERY_CHECK();
-                        ReqKGInterface::parseFromSongAlbumInfo(&item, info.m_songId, value["album_audio_id"].toString());
+                        ReqKGInterface::parseFromSongAlbumInfo(&item, info.m_songId, albums[i]);
                         TTK_NETWORK_QUERY_CHECK();
 
                         albumName = item.m_name;
@@ -17,21 +17,35 @@ QString ReqKGInterface::makeSongArtist(const QString &name)
 
 void ReqKGInterface::parseFromSongAlbumLrc(TTK::MusicSongInformation *info)
 {
-    if(info->m_songId.isEmpty())
+    QNetworkRequest request;
+    if(!ReqKGInterface::makeSongAlbumLrcRequest(info, &request))
     {
         return;
     }
 
-    QNetworkRequest request;
-    request.setUrl(TTK::Algorithm::mdII(KG_SONG_INFO_URL, false).arg(info->m_songId));
-    ReqKGInterface::makeRequestRawHeader(&request);
-
     const QByteArray &bytes = TTK::syncNetworkQueryForGet(&request);
     if(bytes.isEmpty())
     {
         return;
     }
 
+    ReqKGInterface::parseFromSongAlbumLrc(info, bytes);
+}
+
+bool ReqKGInterface::makeSongAlbumLrcRequest(const TTK::MusicSongInformation *info, QNetworkRequest *request)
+{
+    if(info->m_songId.isEmpty())
+    {
+        return false;
+    }
+
+    request->setUrl(TTK::Algorithm::mdII(KG_SONG_INFO_URL, false).arg(info->m_songId));
+    ReqKGInterface::makeRequestRawHeader(request);
+    return true;
+}
+
+void ReqKGInterface::parseFromSongAlbumLrc(TTK::MusicSongInformation *info, const QByteArray &bytes)
+{
     QJson::Parser json;
     bool ok = false;
     const QVariant &data = json.parse(bytes, &ok);
@@ -66,21 +80,44 @@ void ReqKGInterface::parseFromSongAlbumInfo(TTK::MusicSongInformation *info, con
 
 void ReqKGInterface::parseFromSongAlbumInfo(MusicResultDataItem *item, const QString &hash, const QString &album)
 {
-    if(hash.isEmpty() || album.isEmpty())
+    QNetworkRequest request;
+    if(!ReqKGInterface::makeSongAlbumInfoRequest(hash, album, &request))
     {
         return;
     }
 
-    QNetworkRequest request;
-    request.setUrl(TTK::Algorithm::mdII(KG_ALBUM_INFO_URL, false).arg(hash, album));
-    ReqKGInterface::makeRequestRawHeader(&request);
-
     const QByteArray &bytes = TTK::syncNetworkQueryForGet(&request);
     if(bytes.isEmpty())
     {
         return;
     }
 
+    ReqKGInterface::parseFromSongAlbumInfo(item, bytes);
+}
+
+bool ReqKGInterface::makeSongAlbumInfoRequest(const QString &hash, const QString &album, QNetworkRequest *request)
+{
+    if(hash.isEmpty() || album.isEmpty())
+    {
+        return false;
+    }
+
+    request->setUrl(TTK::Algorithm::mdII(KG_ALBUM_INFO_URL, false).arg(hash, album));
+    ReqKGInterface::makeRequestRawHeader(request);
+    return true;
+}
+
+void ReqKGInterface::parseFromSongAlbumInfo(TTK::MusicSongInformation *info, const QByteArray &bytes)
+{
+    MusicResultDataItem item;
+    parseFromSongAlbumInfo(&item, bytes);
+
+    info->m_albumId = item.m_id;
+    info->m_albumName = item.m_name;
+}
+
+void ReqKGInterface::parseFromSongAlbumInfo(MusicResultDataItem *item, const QByteArray &bytes)
+{
     QJson::Parser json;
     bool ok = false;
     const QVariant &data = json.parse(bytes, &ok);
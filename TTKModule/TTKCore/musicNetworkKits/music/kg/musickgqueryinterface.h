@@ -75,6 +75,14 @@ namespace ReqKGInterface
      * Read tags(lrc and album pic) from query results.
      */
     void parseFromSongAlbumLrc(TTK::MusicSongInformation *info);
+    /*!
+     * Make tags(lrc and album pic) request, return false if info is not valid.
+     */
+    bool makeSongAlbumLrcRequest(const TTK::MusicSongInformation *info, QNetworkRequest *request);
+    /*!
+     * Read tags(lrc and album pic) from raw data.
+     */
+    void parseFromSongAlbumLrc(TTK::MusicSongInformation *info, const QByteArray &bytes);
 
     /*!
      * Read album id and name.
@@ -84,6 +92,18 @@ namespace ReqKGInterface
      * Read tags(album info) from query results.
      */
     void parseFromSongAlbumInfo(MusicResultDataItem *item, const QString &hash, const QString &album);
+    /*!
+     * Make tags(album info) request, return false if hash or album is empty.
+     */
+    bool makeSongAlbumInfoRequest(const QString &hash, const QString &album, QNetworkRequest *request);
+    /*!
+     * Read album id and name from raw data.
+     */
+    void parseFromSongAlbumInfo(TTK::MusicSongInformation *info, const QByteArray &bytes);
+    /*!
+     * Read tags(album info) from raw data.
+     */
+    void parseFromSongAlbumInfo(MusicResultDataItem *item, const QByteArray &bytes);
 
     /*!
      * Read tags(size and bitrate and url) from query results.
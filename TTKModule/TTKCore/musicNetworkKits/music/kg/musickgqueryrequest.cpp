@@ -1,4 +1,5 @@
 #include "musickgqueryrequest.h"
+#include "musicquerybatchrequest.h"
 
 MusicKGQueryRequest::MusicKGQueryRequest(QObject *parent)
     : MusicQueryRequest(parent)
@@ -70,6 +71,7 @@ void MusicKGQueryRequest::downLoadFinished()
                 value = value["data"].toMap();
                 m_totalSize = value["total"].toInt();
 
+                TTK::MusicSongInformationList items;
                 const QVariantList &datas = value["info"].toList();
                 for(const QVariant &var : qAsConst(datas))
                 {
@@ -94,16 +96,33 @@ void MusicKGQueryRequest::downLoadFinished()
                     info.m_year.clear();
                     info.m_trackNumber = "0";
 
-                    TTK_NETWORK_QUERY_CHECK();
-                    ReqKGInterface::parseFromSongAlbumLrc(&info);
-                    TTK_NETWORK_QUERY_CHECK();
-
                     if(m_queryMode != QueryMode::Meta)
                     {
-                        TTK_NETWORK_QUERY_CHECK();
                         ReqKGInterface::parseFromSongProperty(&info, value);
-                        TTK_NETWORK_QUERY_CHECK();
+                    }
 
+                    items << info;
+                }
+
+                //Query all detail tags concurrently, instead of one blocking request per result
+                MusicQueryBatchRequest batch;
+                for(TTK::MusicSongInformation &info : items)
+                {
+                    QNetworkRequest request;
+                    if(ReqKGInterface::makeSongAlbumLrcRequest(&info, &request))
+                    {
+                        batch.addRequest(request, &info, ReqKGInterface::parseFromSongAlbumLrc);
+                    }
+                }
+
+                TTK_NETWORK_QUERY_CHECK();
+                batch.exec();
+                TTK_NETWORK_QUERY_CHECK();
+
+                for(const TTK::MusicSongInformation &info : qAsConst(items))
+                {
+                    if(m_queryMode != QueryMode::Meta)
+                    {
                         Q_EMIT createResultItem({info, serverToString()});
                     }
 
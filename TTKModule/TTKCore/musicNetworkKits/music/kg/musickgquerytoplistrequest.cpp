@@ -1,4 +1,5 @@
 #include "musickgquerytoplistrequest.h"
+#include "musicquerybatchrequest.h"
 
 MusicKGQueryToplistRequest::MusicKGQueryToplistRequest(QObject *parent)
     : MusicQueryToplistRequest(parent)
@@ -62,6 +63,8 @@ void MusicKGQueryToplistRequest::downLoadFinished()
 
                 queryToplistInfo(value);
 
+                TTK::MusicSongInformationList items;
+                QStringList albums;
                 const QVariantList &datas = value["info"].toList();
                 for(const QVariant &var : qAsConst(datas))
                 {
@@ -82,14 +85,35 @@ void MusicKGQueryToplistRequest::downLoadFinished()
                     info.m_year.clear();
                     info.m_trackNumber = "0";
 
-                    TTK_NETWORK_QUERY_CHECK();
-                    ReqKGInterface::parseFromSongAlbumLrc(&info);
-                    TTK_NETWORK_QUERY_CHECK();
-                    ReqKGInterface::parseFromSongAlbumInfo(&info, value["album_audio_id"].toString());
-                    TTK_NETWORK_QUERY_CHECK();
                     ReqKGInterface::parseFromSongProperty(&info, value);
-                    TTK_NETWORK_QUERY_CHECK();
+                    items << info;
+                    albums << value["album_audio_id"].toString();
+                }
+
+                //Query all detail tags concurrently, instead of two blocking requests per result
+                MusicQueryBatchRequest batch;
+                for(int i = 0; i < items.count(); ++i)
+                {
+                    TTK::MusicSongInformation *info = &items[i];
+
+                    QNetworkRequest request;
+                    if(ReqKGInterface::makeSongAlbumLrcRequest(info, &request))
+                    {
+                        batch.addRequest(request, info, ReqKGInterface::parseFromSongAlbumLrc);
+                    }
+
+                    if(ReqKGInterface::makeSongAlbumInfoRequest(info->m_songId, albums[i], &request))
+                    {
+                        batch.addRequest(request, info, ReqKGInterface::parseFromSongAlbumInfo);
+                    }
+                }
 
+                TTK_NETWORK_QUERY_CHECK();
+                batch.exec();
+                TTK_NETWORK_QUERY_CHECK();
+
+                for(const TTK::MusicSongInformation &info : qAsConst(items))
+                {
                     Q_EMIT createResultItem({info, serverToString()});
                     m_items << info;
                 }
@@ -38,7 +38,7 @@ void MusicNetworkThread::networkStateChanged()
 {
     TTKConcurrent(
     {
-        const bool block = G_SETTING_PTR->value(MusicSettingManager::CloseNetWorkMode).toBool();
+        const bool block = G_SETTING_PTR->value<MusicSettingManager::CloseNetWorkMode>();
         const QHostInfo &info = QHostInfo::fromName(NETWORK_REQUEST_ADDRESS);
         m_networkState = !info.addresses().isEmpty();
         m_networkState = block ? false : m_networkState;
@@ -26,6 +26,7 @@ HEADERS += \
     $$PWD/musicm3uconfigmanager.h \
     $$PWD/musicplsconfigmanager.h \
     $$PWD/musictkplconfigmanager.h \
+    $$PWD/musictkblconfigmanager.h \
     $$PWD/musicwplconfigmanager.h \
     $$PWD/musicxspfconfigmanager.h \
     $$PWD/musiccsvconfigmanager.h \
@@ -39,6 +40,7 @@ SOURCES += \
     $$PWD/musicm3uconfigmanager.cpp \
     $$PWD/musicplsconfigmanager.cpp \
     $$PWD/musictkplconfigmanager.cpp \
+    $$PWD/musictkblconfigmanager.cpp \
     $$PWD/musicwplconfigmanager.cpp \
     $$PWD/musicxspfconfigmanager.cpp \
     $$PWD/musiccsvconfigmanager.cpp \
@@ -0,0 +1,245 @@
+#include "musictkblconfigmanager.h"
+
+#include <QtEndian>
+
+static constexpr quint32 PLAYLIST_MAGIC = 0x4C424B54; // "TKBL"
+static constexpr quint32 PLAYLIST_VERSION = 1;
+static constexpr int HEADER_SIZE = 32;
+static constexpr int LIST_RECORD_SIZE = 24;
+static constexpr int SONG_RECORD_SIZE = 32;
+
+/*
+ * Layout, all values are little endian
+ *  header  : magic u32, version u32, list count u32, song count u32, string count u32, reserved u32, string data size u64
+ *  lists   : id i32, index i32, name u32, sort type i32, sort order i32, song count u32
+ *  songs   : size i64, add time i64, path u32, name u32, duration u32, play count i32
+ *  strings : offsets u32[string count + 1] in utf16 units, utf16 data
+ */
+
+template <typename T>
+static inline T readValue(const uchar *&data)
+{
+    const T value = qFromLittleEndian<T>(data);
+    data += sizeof(T);
+    return value;
+}
+
+template <typename T>
+static inline void writeValue(QByteArray &buffer, T value)
+{
+    uchar data[sizeof(T)];
+    qToLittleEndian<T>(value, data);
+    buffer.append(TTKReinterpretCast(const char*, data), sizeof(T));
+}
+
+static quint32 internString(const QString &value, QHash<QString, quint32> &table, QStringList &strings)
+{
+    const auto it = table.constFind(value);
+    if(it != table.constEnd())
+    {
+        return it.value();
+    }
+
+    const quint32 index = strings.count();
+    table.insert(value, index);
+    strings << value;
+    return index;
+}
+
+
+MusicTKBLConfigManager::MusicTKBLConfigManager()
+    : MusicPlaylistRenderer()
+    , MusicPlaylistInterface()
+{
+
+}
+
+bool MusicTKBLConfigManager::readBuffer(MusicSongItemList &items)
+{
+    const qint64 size = m_file.size();
+    uchar *data = m_file.map(0, size);
+    if(data)
+    {
+        const bool state = readBuffer(data, size, items);
+        m_file.unmap(data);
+        return state;
+    }
+
+    // fall back when file system does not support mapping
+    const QByteArray &buffer = m_file.readAll();
+    return readBuffer(TTKReinterpretCast(const uchar*, buffer.constData()), buffer.size(), items);
+}
+
+bool MusicTKBLConfigManager::writeBuffer(const MusicSongItemList &items)
+{
+    if(items.isEmpty())
+    {
+        return false;
+    }
+
+    QHash<QString, quint32> table;
+    QStringList strings;
+    QByteArray lists, songs;
+    quint32 songCount = 0;
+
+    for(int i = 0; i < items.count(); ++i)
+    {
+        const MusicSongItem &item = items[i];
+        writeValue<qint32>(lists, item.m_id);
+        writeValue<qint32>(lists, i);
+        writeValue<quint32>(lists, internString(item.m_itemName, table, strings));
+        writeValue<qint32>(lists, item.m_sort.m_type);
+        writeValue<qint32>(lists, item.m_sort.m_order);
+        writeValue<quint32>(lists, item.m_songs.count());
+
+        for(const MusicSong &song : qAsConst(item.m_songs))
+        {
+            // unknown attributes are kept unknown, never stat file here
+            writeValue<qint64>(songs, song.hasAttributes() ? song.size() : -1);
+            writeValue<qint64>(songs, song.hasAttributes() ? song.addTime() : -1);
+            writeValue<quint32>(songs, internString(song.path(), table, strings));
+            writeValue<quint32>(songs, internString(song.name(), table, strings));
+            writeValue<quint32>(songs, internString(song.duration(), table, strings));
+            writeValue<qint32>(songs, song.playCount());
+        }
+        songCount += item.m_songs.count();
+    }
+
+    QByteArray offsets, texts;
+    quint32 offset = 0;
+    writeValue<quint32>(offsets, offset);
+
+    for(const QString &value : qAsConst(strings))
+    {
+        for(const QChar &c : value)
+        {
+            writeValue<quint16>(texts, c.unicode());
+        }
+
+        offset += value.length();
+        writeValue<quint32>(offsets, offset);
+    }
+
+    QByteArray header;
+    writeValue<quint32>(header, PLAYLIST_MAGIC);
+    writeValue<quint32>(header, PLAYLIST_VERSION);
+    writeValue<quint32>(header, items.count());
+    writeValue<quint32>(header, songCount);
+    writeValue<quint32>(header, strings.count());
+    writeValue<quint32>(header, 0);
+    writeValue<quint64>(header, texts.size());
+
+    m_file.write(header);
+    m_file.write(lists);
+    m_file.write(songs);
+    m_file.write(offsets);
+    m_file.write(texts);
+    return m_file.error() == QFile::NoError;
+}
+
+bool MusicTKBLConfigManager::readBuffer(const uchar *data, qint64 size, MusicSongItemList &items) const
+{
+    if(size < HEADER_SIZE)
+    {
+        return false;
+    }
+
+    const uchar *p = data;
+    const quint32 magic = readValue<quint32>(p);
+    const quint32 version = readValue<quint32>(p);
+    if(magic != PLAYLIST_MAGIC || version != PLAYLIST_VERSION)
+    {
+        TTK_WARN_STREAM("Binary playlist file version mismatch");
+        return false;
+    }
+
+    const quint32 listCount = readValue<quint32>(p);
+    const quint32 songCount = readValue<quint32>(p);
+    const quint32 stringCount = readValue<quint32>(p);
+    readValue<quint32>(p);
+    const quint64 textSize = readValue<quint64>(p);
+
+    const qint64 listOffset = HEADER_SIZE;
+    const qint64 songOffset = listOffset + qint64(listCount) * LIST_RECORD_SIZE;
+    const qint64 stringOffset = songOffset + qint64(songCount) * SONG_RECORD_SIZE;
+    const qint64 textOffset = stringOffset + (qint64(stringCount) + 1) * sizeof(quint32);
+    if(textOffset + qint64(textSize) != size)
+    {
+        TTK_WARN_STREAM("Binary playlist file is corrupted");
+        return false;
+    }
+
+    // decode each unique string once, songs share them implicitly
+    QVector<QString> strings(stringCount);
+    p = data + stringOffset;
+    quint32 start = readValue<quint32>(p);
+    for(quint32 i = 0; i < stringCount; ++i)
+    {
+        const quint32 end = readValue<quint32>(p);
+        if(end < start || qint64(end) * 2 > qint64(textSize))
+        {
+            return false;
+        }
+
+        const uchar *text = data + textOffset + qint64(start) * 2;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        strings[i] = QString(TTKReinterpretCast(const QChar*, text), end - start);
+#else
+        QString &value = strings[i];
+        value.resize(end - start);
+        for(quint32 j = 0; j < end - start; ++j)
+        {
+            value[j] = QChar(qFromLittleEndian<quint16>(text + j * 2));
+        }
+#endif
+        start = end;
+    }
+
+    MusicSongItemList results;
+    const uchar *songs = data + songOffset;
+    quint32 songIndex = 0;
+    p = data + listOffset;
+
+    for(quint32 i = 0; i < listCount; ++i)
+    {
+        MusicSongItem item;
+        item.m_id = readValue<qint32>(p);
+        item.m_itemIndex = readValue<qint32>(p);
+        const quint32 name = readValue<quint32>(p);
+        item.m_sort.m_type = readValue<qint32>(p);
+        item.m_sort.m_order = TTKStaticCast(Qt::SortOrder, readValue<qint32>(p));
+        const quint32 count = readValue<quint32>(p);
+
+        if(name >= stringCount || count > songCount - songIndex)
+        {
+            return false;
+        }
+
+        item.m_itemName = strings[name];
+        item.m_songs.reserve(count);
+
+        for(quint32 j = 0; j < count; ++j, ++songIndex)
+        {
+            const qint64 fileSize = readValue<qint64>(songs);
+            const qint64 addTime = readValue<qint64>(songs);
+            const quint32 path = readValue<quint32>(songs);
+            const quint32 songName = readValue<quint32>(songs);
+            const quint32 duration = readValue<quint32>(songs);
+            const qint32 playCount = readValue<qint32>(songs);
+
+            if(path >= stringCount || songName >= stringCount || duration >= stringCount)
+            {
+                return false;
+            }
+
+            MusicSong song = fileSize < 0 ? MusicSong(strings[path], strings[duration], strings[songName], true)
+                                          : MusicSong(strings[path], fileSize, addTime, strings[duration], strings[songName]);
+            song.setPlayCount(playCount);
+            item.m_songs << song;
+        }
+        results << item;
+    }
+
+    items << results;
+    return true;
+}
@@ -1,37 +1,64 @@
 #include "musictkplconfigmanager.h"
 
+static constexpr int MAX_RESERVE_COUNT = 100000;
+
 MusicTKPLConfigManager::MusicTKPLConfigManager()
-    : TTKAbstractXml()
+    : TTKAbstractStreamXml()
     , MusicPlaylistInterface()
+    , m_durationLookup(true)
 {
 
 }
 
 bool MusicTKPLConfigManager::readBuffer(MusicSongItemList &items)
 {
-    const QDomNodeList &nodes = m_document->elementsByTagName("musicList");
-    for(int i = 0; i < nodes.count(); ++i)
+    MusicSongItemList results;
+    while(readNextElement())
     {
-        const QDomNode &node = nodes.item(i);
-        MusicSongItem item;
-        item.m_songs = readMusicFilePath(node);
+        const QString &name = nodeName();
+        if(name == "musicList")
+        {
+            MusicSongItem item;
+            item.m_itemIndex = readAttribute("index").toInt();
+            item.m_itemName = readAttribute("name");
+
+            bool ok = false;
+            item.m_id = readAttribute("id").toInt(&ok);
+            if(!ok)
+            {
+                item.m_id = item.m_itemIndex;
+            }
 
-        const QDomElement &element = node.toElement();
-        item.m_itemIndex = element.attribute("index").toInt();
-        item.m_itemName = element.attribute("name");
+            const QString &string = readAttribute("sortIndex");
+            item.m_sort.m_type = string.isEmpty() ? -1 : string.toInt();
+            item.m_sort.m_order = TTKStaticCast(Qt::SortOrder, readAttribute("sortType").toInt());
 
-        bool ok = false;
-        item.m_id = element.attribute("id").toInt(&ok);
-        if(!ok)
+            const int count = readAttribute("count").toInt();
+            if(count > 0)
+            {
+                item.m_songs.reserve(qMin(count, MAX_RESERVE_COUNT));
+            }
+            results << item;
+        }
+        else if(name == "value" && !results.isEmpty())
         {
-            item.m_id = item.m_itemIndex;
+            const QString &time = readAttribute("time");
+            const QString &songName = readAttribute("name");
+            const int playCount = readAttribute("playCount").toInt();
+
+            MusicSong song(readText(), time, songName, true);
+            song.setPlayCount(playCount);
+            results.back().m_songs << song;
         }
+    }
 
-        const QString &string = element.attribute("sortIndex");
-        item.m_sort.m_type = string.isEmpty() ? -1 : string.toInt();
-        item.m_sort.m_order = TTKStaticCast(Qt::SortOrder, element.attribute("sortType").toInt());
-        items << item;
+    if(hasError())
+    {
+        TTK_ERROR_STREAM("Read tkpl playlist error" << m_reader->errorString());
+        return false;
     }
+
+    items << results;
     return true;
 }
 
@@ -42,47 +69,31 @@ bool MusicTKPLConfigManager::writeBuffer(const MusicSongItemList &items)
         return false;
     }
 
-    createProcessingInstruction();
-    QDomElement rootDom = createRoot(TTK_APP_NAME);
+    writeStartDocument(TTK_APP_NAME);
 
     for(int i = 0; i < items.count(); ++i)
     {
         const MusicSongItem &item = items[i];
-        QDomElement pathDom = writeDomMultiElement(rootDom, "musicList", {{"index", i},
-                                                                          {"id", item.m_id},
-                                                                          {"name", item.m_itemName},
-                                                                          {"count", item.m_songs.count()},
-                                                                          {"sortIndex", item.m_sort.m_type},
-                                                                          {"sortType", item.m_sort.m_order}});
+        writeStartElement("musicList", {{"index", i},
+                                        {"id", item.m_id},
+                                        {"name", item.m_itemName},
+                                        {"count", item.m_songs.count()},
+                                        {"sortIndex", item.m_sort.m_type},
+                                        {"sortType", item.m_sort.m_order}});
         for(const MusicSong &song : qAsConst(item.m_songs))
         {
             QString duration = song.duration();
-            if(item.m_itemIndex == MUSIC_NETWORK_LIST && duration == TTK_DEFAULT_STR)
+            if(m_durationLookup && item.m_itemIndex == MUSIC_NETWORK_LIST && duration == TTK_DEFAULT_STR)
             {
                 duration = TTK::generateNetworkSongTime(song.path());
             }
 
-            writeDomMultiElement(pathDom, "value", {{"name", song.name()},
-                                                    {"playCount", song.playCount()},
-                                                    {"time", duration}}, song.path());
+            writeElement("value", {{"name", song.name()},
+                                   {"playCount", song.playCount()},
+                                   {"time", duration}}, song.path());
         }
+        writeEndElement();
     }
 
-    save();
-    return true;
-}
-
-MusicSongList MusicTKPLConfigManager::readMusicFilePath(const QDomNode &node) const
-{
-    const QDomNodeList &nodes = node.childNodes();
-
-    MusicSongList songs;
-    for(int i = 0; i < nodes.count(); ++i)
-    {
-        const QDomElement &element = nodes.item(i).toElement();
-        MusicSong song(element.text(), element.attribute("time"), element.attribute("name"), true);
-        song.setPlayCount(element.attribute("playCount").toInt());
-        songs << song;
-    }
-    return songs;
+    return writeEndDocument();
 }
@@ -19,13 +19,14 @@
  * with this program; If not, see <http://www.gnu.org/licenses/>.
  ***************************************************************************/
 
-#include "ttkabstractxml.h"
+#include "ttkabstractstreamxml.h"
 #include "musicplaylistinterface.h"
 
 /*! @brief The class of the tkpl config manager.
+ * Playlists are read and written by stream, so large libraries never build a document tree.
  * @author Greedysky <greedysky@163.com>
  */
-class TTK_MODULE_EXPORT MusicTKPLConfigManager : public TTKAbstractXml, public MusicPlaylistInterface
+class TTK_MODULE_EXPORT MusicTKPLConfigManager : public TTKAbstractStreamXml, public MusicPlaylistInterface
 {
     TTK_DECLARE_MODULE(MusicTKPLConfigManager)
 public:
@@ -34,6 +35,11 @@ public:
      */
     MusicTKPLConfigManager();
 
+    /*!
+     * Set network song duration lookup enabled or not when writing, default is enabled.
+     */
+    inline void setDurationLookupEnabled(bool enabled) noexcept { m_durationLookup = enabled; }
+
     /*!
      * Read datas from buffer.
      */
@@ -44,10 +50,7 @@ public:
     virtual bool writeBuffer(const MusicSongItemList &items) override final;
 
 private:
-    /*!
-     * Read Music File Path.
-     */
-    MusicSongList readMusicFilePath(const QDomNode &node) const;
+    bool m_durationLookup;
 
 };
 
@@ -0,0 +1,204 @@
+#include "musicsongsearchindex.h"
+
+static constexpr int SEARCH_GRAM_SIZE = 3;
+
+static QString generateSearchKey(const QString &text)
+{
+    // compatibility decomposition maps full width forms to ascii, then accent marks are dropped
+    const QString &value = text.normalized(QString::NormalizationForm_KD).toCaseFolded();
+
+    QString key;
+    key.reserve(value.length());
+    for(const QChar &c : qAsConst(value))
+    {
+        if(c.category() != QChar::Mark_NonSpacing)
+        {
+            key.append(c);
+        }
+    }
+    return key;
+}
+
+static inline quint64 generateSearchGram(const QString &key, int index)
+{
+    return (quint64(key[index].unicode()) << 32) | (quint64(key[index + 1].unicode()) << 16) | quint64(key[index + 2].unicode());
+}
+
+
+MusicSongSearchIndex::MusicSongSearchIndex()
+    : m_removed(0)
+{
+
+}
+
+void MusicSongSearchIndex::update(const MusicSongList &songs)
+{
+    const int count = songs.count();
+    const int size = m_names.count();
+
+    int prefix = 0;
+    while(prefix < count && prefix < size && m_names[prefix] == songs[prefix].name())
+    {
+        ++prefix;
+    }
+
+    if(prefix == count && prefix == size)
+    {
+        return;
+    }
+
+    int suffix = 0;
+    while(suffix < count - prefix && suffix < size - prefix && m_names[size - 1 - suffix] == songs[count - 1 - suffix].name())
+    {
+        ++suffix;
+    }
+
+    for(int i = prefix; i < size - suffix; ++i)
+    {
+        const int id = m_ids[i];
+        m_keys[id].clear();
+        m_positions[id] = -1;
+        ++m_removed;
+    }
+
+    QStringList names;
+    QVector<int> ids;
+    for(int i = prefix; i < count - suffix; ++i)
+    {
+        const QString &name = songs[i].name();
+        names << name;
+        ids << appendEntry(name);
+    }
+
+    m_names = m_names.mid(0, prefix) + names + m_names.mid(size - suffix);
+    m_ids = m_ids.mid(0, prefix) + ids + m_ids.mid(size - suffix);
+
+    for(int i = prefix; i < m_ids.count(); ++i)
+    {
+        m_positions[m_ids[i]] = i;
+    }
+
+    m_lastKey.clear();
+    m_lastResult.clear();
+
+    if(m_removed > m_keys.count() / 2)
+    {
+        rebuild();
+    }
+}
+
+TTKIntList MusicSongSearchIndex::search(const QString &text)
+{
+    TTKIntList result;
+    const QString &key = generateSearchKey(text);
+    const int count = m_ids.count();
+
+    if(key.isEmpty())
+    {
+        for(int i = 0; i < count; ++i)
+        {
+            result << i;
+        }
+    }
+    else if(!m_lastKey.isEmpty() && key.contains(m_lastKey))
+    {
+        // previous result is a superset of the current one
+        for(int pos : qAsConst(m_lastResult))
+        {
+            if(m_keys[m_ids[pos]].contains(key))
+            {
+                result << pos;
+            }
+        }
+    }
+    else if(key.length() >= SEARCH_GRAM_SIZE)
+    {
+        // verify candidates from the shortest trigram posting
+        const QVector<int> *candidates = nullptr;
+        for(int i = 0; i <= key.length() - SEARCH_GRAM_SIZE; ++i)
+        {
+            const auto it = m_grams.constFind(generateSearchGram(key, i));
+            if(it == m_grams.constEnd())
+            {
+                candidates = nullptr;
+                break;
+            }
+
+            if(!candidates || it.value().count() < candidates->count())
+            {
+                candidates = &it.value();
+            }
+        }
+
+        if(candidates)
+        {
+            for(int id : qAsConst(*candidates))
+            {
+                const int pos = m_positions[id];
+                if(pos >= 0 && m_keys[id].contains(key))
+                {
+                    result << pos;
+                }
+            }
+            std::sort(result.begin(), result.end());
+        }
+    }
+    else
+    {
+        for(int i = 0; i < count; ++i)
+        {
+            if(m_keys[m_ids[i]].contains(key))
+            {
+                result << i;
+            }
+        }
+    }
+
+    m_lastKey = key;
+    m_lastResult = result;
+    return result;
+}
+
+void MusicSongSearchIndex::clear()
+{
+    m_removed = 0;
+    m_names.clear();
+    m_ids.clear();
+    m_positions.clear();
+    m_keys.clear();
+    m_grams.clear();
+    m_lastKey.clear();
+    m_lastResult.clear();
+}
+
+int MusicSongSearchIndex::appendEntry(const QString &name)
+{
+    const int id = m_keys.count();
+    const QString &key = generateSearchKey(name);
+    m_keys << key;
+    m_positions << -1;
+
+    for(int i = 0; i <= key.length() - SEARCH_GRAM_SIZE; ++i)
+    {
+        QVector<int> &ids = m_grams[generateSearchGram(key, i)];
+        if(ids.isEmpty() || ids.back() != id)
+        {
+            ids << id;
+        }
+    }
+    return id;
+}
+
+void MusicSongSearchIndex::rebuild()
+{
+    const QStringList names(m_names);
+    clear();
+
+    m_names = names;
+    for(int i = 0; i < m_names.count(); ++i)
+    {
+        const int id = appendEntry(m_names[i]);
+        m_ids << id;
+        m_positions[id] = i;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef MUSICSONGSEARCHINDEX_H
+#define MUSICSONGSEARCHINDEX_H
+
+/***************************************************************************
+ * This file is part of the TTK Music Player project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+
+#include "musicsong.h"
+
+/*! @brief The class of the playlist song search index.
+ * Song names are folded to case and diacritic insensitive keys and indexed
+ * by trigrams, the index follows playlist changes by the changed range only,
+ * and a longer query narrows the previous result instead of rescanning.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicSongSearchIndex
+{
+    TTK_DECLARE_MODULE(MusicSongSearchIndex)
+public:
+    /*!
+     * Object constructor.
+     */
+    MusicSongSearchIndex();
+
+    /*!
+     * Update index by current playlist songs, only changed range is reindexed.
+     */
+    void update(const MusicSongList &songs);
+    /*!
+     * Search song rows whose name contains the given text.
+     */
+    TTKIntList search(const QString &text);
+    /*!
+     * Clear all index items.
+     */
+    void clear();
+
+private:
+    /*!
+     * Add index entry by song name and return the entry id.
+     */
+    int appendEntry(const QString &name);
+    /*!
+     * Rebuild all index entries to drop removed ones.
+     */
+    void rebuild();
+
+    int m_removed;
+    QStringList m_names;
+    QVector<int> m_ids, m_positions;
+    QVector<QString> m_keys;
+    QHash<quint64, QVector<int>> m_grams;
+    QString m_lastKey;
+    TTKIntList m_lastResult;
+
+};
+
+#endif // MUSICSONGSEARCHINDEX_H
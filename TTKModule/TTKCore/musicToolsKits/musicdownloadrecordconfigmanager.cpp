@@ -13,42 +13,44 @@ QString TTK::toString(Record type)
 
 
 MusicDownloadRecordConfigManager::MusicDownloadRecordConfigManager()
-    : TTKAbstractXml()
+    : TTKAbstractStreamXml()
 {
 
 }
 
 bool MusicDownloadRecordConfigManager::readBuffer(MusicSongList &items)
 {
-    const QDomNodeList &nodes = m_document->elementsByTagName("value");
-    for(int i = 0; i < nodes.count(); ++i)
+    while(readNextElement())
     {
-        const QDomElement &element = nodes.item(i).toElement();
+        if(nodeName() != "value")
+        {
+            continue;
+        }
 
         MusicSong record;
-        record.setName(element.attribute("name"));
-        record.setSizeStr(element.attribute("size"));
-        record.setAddTimeStr(element.attribute("time"));
-        record.setPath(element.text());
+        record.setName(readAttribute("name"));
+        record.setSizeStr(readAttribute("size"));
+        record.setAddTimeStr(readAttribute("time"));
+        record.setPath(readText());
         items << record;
     }
 
-    return true;
+    return !hasError();
 }
 
 bool MusicDownloadRecordConfigManager::writeBuffer(const MusicSongList &items)
 {
-    createProcessingInstruction();
-    QDomElement rootDom = createRoot(TTK_APP_NAME);
-    QDomElement recordDom = writeDomElement(rootDom, "record");
+    writeStartDocument(TTK_APP_NAME);
+    writeStartElement("record");
 
     for(const MusicSong &record : qAsConst(items))
     {
-        writeDomMultiElement(recordDom, "value", {{"name", record.name()},
-                                                  {"size", record.sizeStr()},
-                                                  {"time", record.addTimeStr()}}, record.path());
+        writeElement("value", {{"name", record.name()},
+                               {"size", record.sizeStr()},
+                               {"time", record.addTimeStr()}}, record.path());
     }
 
-    save();
+    writeEndElement();
+    writeEndDocument();
     return true;
 }
@@ -19,7 +19,7 @@
  * with this program; If not, see <http://www.gnu.org/licenses/>.
  ***************************************************************************/
 
-#include "ttkabstractxml.h"
+#include "ttkabstractstreamxml.h"
 #include "musicsong.h"
 #include "musicnetworkdefines.h"
 
@@ -39,7 +39,7 @@ namespace TTK
 /*! @brief The class of the download record manager.
  * @author Greedysky <greedysky@163.com>
  */
-class TTK_MODULE_EXPORT MusicDownloadRecordConfigManager : public TTKAbstractXml, public TTKAbstractReadWriteInterface<MusicSongList>
+class TTK_MODULE_EXPORT MusicDownloadRecordConfigManager : public TTKAbstractStreamXml, public TTKAbstractReadWriteInterface<MusicSongList>
 {
     TTK_DECLARE_MODULE(MusicDownloadRecordConfigManager)
 public:
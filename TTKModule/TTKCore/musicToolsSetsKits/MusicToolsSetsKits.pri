@@ -23,6 +23,9 @@ HEADERS += \
     $$PWD/musicbackupmodule.h \
     $$PWD/musictimerautomodule.h \
     $$PWD/musicsongsmanagerthread.h \
+    $$PWD/musicsongimportthread.h \
+    $$PWD/musictranscodescheduler.h \
+    $$PWD/musicreplaygainanalyzer.h \
     $$PWD/musicaudiorecordermodule.h \
     $$PWD/musicnetworktestthread.h \
     $$PWD/musicsongchecktoolsthread.h \
@@ -33,6 +36,9 @@ SOURCES += \
     $$PWD/musicbackupmodule.cpp \
     $$PWD/musictimerautomodule.cpp \
     $$PWD/musicsongsmanagerthread.cpp \
+    $$PWD/musicsongimportthread.cpp \
+    $$PWD/musictranscodescheduler.cpp \
+    $$PWD/musicreplaygainanalyzer.cpp \
     $$PWD/musicaudiorecordermodule.cpp \
     $$PWD/musicnetworktestthread.cpp \
     $$PWD/musicsongchecktoolsthread.cpp
@@ -1,8 +1,12 @@
 #include "musicbackupmodule.h"
 #include "musicsettingmanager.h"
-#include "musictkplconfigmanager.h"
 #include "musicsongscontainerwidget.h"
 #include "musicfileutils.h"
+#include "musictkplconfigmanager.h"
+
+#include <QCryptographicHash>
+
+static constexpr int BACKUP_MAX_COUNT = 7;
 
 MusicAbstractBackup::MusicAbstractBackup(int interval, QObject *parent)
     : QObject(parent)
@@ -23,14 +27,45 @@ void MusicAbstractBackup::stop()
 }
 
 
-MusicPlaylistBackupModule::MusicPlaylistBackupModule(QObject *parent)
-    : MusicAbstractBackup(1000 * 60 * 10 /*10 minutes*/, parent)
+MusicPlaylistBackupThread::MusicPlaylistBackupThread(QObject *parent)
+    : TTKAbstractThread(parent)
 {
 
 }
 
-void MusicPlaylistBackupModule::runBackup()
+void MusicPlaylistBackupThread::setItems(const MusicSongItemList &items)
 {
+    m_items = items;
+}
+
+void MusicPlaylistBackupThread::run()
+{
+    if(m_items.isEmpty())
+    {
+        return;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    for(const MusicSongItem &item : qAsConst(m_items))
+    {
+        const QStringList list{QString::number(item.m_id), item.m_itemName, QString::number(item.m_sort.m_type), QString::number(TTKStaticCast(int, item.m_sort.m_order))};
+        hash.addData(list.join("|").toUtf8());
+
+        for(const MusicSong &song : qAsConst(item.m_songs))
+        {
+            const QStringList values{song.path(), song.name(), song.duration(), QString::number(song.playCount())};
+            hash.addData(values.join("|").toUtf8());
+        }
+    }
+
+    // nothing changed since last backup
+    const QByteArray &result = hash.result();
+    if(result == m_hash)
+    {
+        m_items.clear();
+        return;
+    }
+
     const QString &root = APPBACKUP_DIR_FULL + "playlist";
     const QString &child = QDate::currentDate().toString(TTK_DATE_FORMAT);
 
@@ -38,28 +73,79 @@ void MusicPlaylistBackupModule::runBackup()
     dir.mkpath(child);
 
     const QFileInfoList &dirList = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Time | QDir::Reversed);
-    if(dirList.count() > 7)
+    if(dirList.count() > BACKUP_MAX_COUNT)
     {
         TTK::File::removeRecursively(dirList.front().absoluteFilePath());
     }
 
     dir.cd(child);
 
-    MusicTKPLConfigManager manager;
-    if(!manager.load(QString("%1/%2%3").arg(dir.absolutePath()).arg(TTKDateTime::currentTimestamp()).arg(TKF_FILE)))
+    if(writeBuffer(QString("%1/%2%3").arg(dir.absolutePath()).arg(TTKDateTime::currentTimestamp()).arg(TKF_FILE)))
     {
-        return;
+        m_hash = result;
     }
-
-    manager.writeBuffer(MusicSongsContainerWidget::instance()->items());
+    m_items.clear();
 
     const QFileInfoList &fileList = dir.entryInfoList(QDir::Files, QDir::Time | QDir::Reversed);
-    if(fileList.count() > 7)
+    if(fileList.count() > BACKUP_MAX_COUNT)
     {
         QFile::remove(fileList.front().absoluteFilePath());
     }
 }
 
+bool MusicPlaylistBackupThread::writeBuffer(const QString &path)
+{
+    // write into temp file first, a half written backup never replaces a good one
+    const QString &temp = path + ".tmp";
+    bool state = false;
+    {
+        MusicTKPLConfigManager manager;
+        if(!manager.load(temp))
+        {
+            TTK_ERROR_STREAM("Write playlist backup file error" << temp);
+            return false;
+        }
+
+        // backups keep durations as they are, network songs are never decoded here
+        manager.setDurationLookupEnabled(false);
+        state = manager.writeBuffer(m_items);
+    }
+
+    if(!m_running || !state)
+    {
+        QFile::remove(temp);
+        return false;
+    }
+
+    QFile::remove(path);
+    return QFile::rename(temp, path);
+}
+
+
+MusicPlaylistBackupModule::MusicPlaylistBackupModule(QObject *parent)
+    : MusicAbstractBackup(1000 * 60 * 10 /*10 minutes*/, parent)
+{
+
+}
+
+MusicPlaylistBackupModule::~MusicPlaylistBackupModule()
+{
+    // let the pending backup finish writing
+    m_thread.wait();
+}
+
+void MusicPlaylistBackupModule::runBackup()
+{
+    if(m_thread.isRunning())
+    {
+        return;
+    }
+
+    // list copy is implicitly shared, snapshot costs nothing on ui thread
+    m_thread.setItems(MusicSongsContainerWidget::instance()->items());
+    m_thread.start();
+}
+
 
 MusicBackupModule::MusicBackupModule()
 {
@@ -20,7 +20,8 @@
  ***************************************************************************/
 
 #include <QTimer>
-#include "ttkmoduleexport.h"
+#include "musicsong.h"
+#include "ttkabstractthread.h"
 
 /*! @brief The class of the abstract backup module.
  * @author Greedysky <greedysky@163.com>
@@ -55,6 +56,42 @@ private:
 };
 
 
+/*! @brief The class of the playlist backup thread.
+ * Hash the playlist snapshot and stream it to backup file only when content changed.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicPlaylistBackupThread : public TTKAbstractThread
+{
+    Q_OBJECT
+    TTK_DECLARE_MODULE(MusicPlaylistBackupThread)
+public:
+    /*!
+     * Object constructor.
+     */
+    explicit MusicPlaylistBackupThread(QObject *parent = nullptr);
+
+    /*!
+     * Set playlist snapshot to backup.
+     */
+    void setItems(const MusicSongItemList &items);
+
+private:
+    /*!
+     * Thread run now.
+     */
+    virtual void run() override final;
+
+    /*!
+     * Write playlist snapshot to file by tkpl config manager.
+     */
+    bool writeBuffer(const QString &path);
+
+    QByteArray m_hash;
+    MusicSongItemList m_items;
+
+};
+
+
 /*! @brief The class of the playlist backup module.
  * @author Greedysky <greedysky@163.com>
  */
@@ -66,6 +103,10 @@ public:
      * Object constructor.
      */
     explicit MusicPlaylistBackupModule(QObject *parent = nullptr);
+    /*!
+     * Object destructor.
+     */
+    ~MusicPlaylistBackupModule();
 
 public Q_SLOTS:
     /*!
@@ -73,6 +114,9 @@ public Q_SLOTS:
      */
     virtual void runBackup() override final;
 
+private:
+    MusicPlaylistBackupThread m_thread;
+
 };
 
 
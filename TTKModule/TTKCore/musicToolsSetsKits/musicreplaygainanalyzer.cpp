@@ -0,0 +1,429 @@
+#include "musicreplaygainanalyzer.h"
+#include "musicsongmeta.h"
+
+#include <qmath.h>
+#include <functional>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <qmmp/decoder.h>
+#include <qmmp/decoderfactory.h>
+#include <qmmp/audioconverter.h>
+
+static constexpr double REPLAYGAIN_REFERENCE = -18.0;
+static constexpr double LOUDNESS_MIN = -70.0;
+static constexpr int HISTOGRAM_STEPS = 10;
+static constexpr int HISTOGRAM_SIZE = 80 * HISTOGRAM_STEPS;
+static constexpr int DECODE_BUFFER_SIZE = 64 * 1024;
+
+static inline double energyToLoudness(double energy)
+{
+    return -0.691 + 10.0 * log10(energy);
+}
+
+static inline double loudnessToEnergy(double loudness)
+{
+    return pow(10.0, (loudness + 0.691) / 10.0);
+}
+
+static inline double histogramLoudness(int index)
+{
+    return LOUDNESS_MIN + (index + 0.5) / HISTOGRAM_STEPS;
+}
+
+static bool integratedLoudness(const QVector<quint32> &histogram, double &loudness)
+{
+    // absolute gate at -70 LUFS is applied when blocks are binned, then relative gate 10 LU below the gated mean
+    double energy = 0;
+    quint64 count = 0;
+    for(int i = 0; i < histogram.count(); ++i)
+    {
+        energy += histogram[i] * loudnessToEnergy(histogramLoudness(i));
+        count += histogram[i];
+    }
+
+    if(count == 0)
+    {
+        return false;
+    }
+
+    const double threshold = energyToLoudness(energy / count) - 10.0;
+    energy = 0;
+    count = 0;
+
+    for(int i = 0; i < histogram.count(); ++i)
+    {
+        if(histogramLoudness(i) >= threshold)
+        {
+            energy += histogram[i] * loudnessToEnergy(histogramLoudness(i));
+            count += histogram[i];
+        }
+    }
+
+    if(count == 0)
+    {
+        return false;
+    }
+
+    loudness = energyToLoudness(energy / count);
+    return true;
+}
+
+static double replayGain(const QVector<quint32> &histogram)
+{
+    double loudness = 0;
+    return integratedLoudness(histogram, loudness) ? REPLAYGAIN_REFERENCE - loudness : 0;
+}
+
+static QString albumKey(const QString &path)
+{
+    // files of one directory with the same album tag are one album, untagged ones are grouped by directory
+    MusicSongMeta meta;
+    const QString &album = meta.read(path) ? meta.album() : QString();
+    return QFileInfo(path).absolutePath() + TTK_SEPARATOR + album;
+}
+
+
+/*! @brief The class of the EBU R128 loudness meter.
+ * K-weighting filters and 400ms gating blocks with 75% overlap, see ITU-R BS.1770.
+ * @author Greedysky <greedysky@163.com>
+ */
+class MusicLoudnessMeter
+{
+public:
+    MusicLoudnessMeter(int sampleRate, int channels)
+        : m_channels(channels),
+          m_hop(qMax(1, sampleRate / 10)),
+          m_hopCount(0),
+          m_blockCount(0),
+          m_sum(0)
+    {
+        double f0 = 1681.974450955533;
+        double gain = 3.999843853973347;
+        double q = 0.7071752369554196;
+        double k = tan(M_PI * f0 / sampleRate);
+
+        const double vh = pow(10.0, gain / 20.0);
+        const double vb = pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        m_shelf.m_b0 = (vh + vb * k / q + k * k) / a0;
+        m_shelf.m_b1 = 2.0 * (k * k - vh) / a0;
+        m_shelf.m_b2 = (vh - vb * k / q + k * k) / a0;
+        m_shelf.m_a1 = 2.0 * (k * k - 1.0) / a0;
+        m_shelf.m_a2 = (1.0 - k / q + k * k) / a0;
+
+        f0 = 38.13547087602444;
+        q = 0.5003270373238773;
+        k = tan(M_PI * f0 / sampleRate);
+
+        m_highpass.m_b0 = 1.0;
+        m_highpass.m_b1 = -2.0;
+        m_highpass.m_b2 = 1.0;
+        m_highpass.m_a1 = 2.0 * (k * k - 1.0) / (1.0 + k / q + k * k);
+        m_highpass.m_a2 = (1.0 - k / q + k * k) / (1.0 + k / q + k * k);
+
+        m_state.fill(0, channels * 4);
+        m_weights.fill(1.0, channels);
+        if(channels == 6)
+        {
+            // 5.1 layout, LFE is not measured and surround channels are weighted by 1.41
+            m_weights[3] = 0.0;
+            m_weights[4] = 1.41;
+            m_weights[5] = 1.41;
+        }
+
+        for(int i = 0; i < 4; ++i)
+        {
+            m_blocks[i] = 0;
+        }
+        m_result.m_histogram.fill(0, HISTOGRAM_SIZE);
+    }
+
+    void process(const float *data, int frames)
+    {
+        for(int i = 0; i < frames; ++i)
+        {
+            for(int c = 0; c < m_channels; ++c)
+            {
+                const double x = data[i * m_channels + c];
+                m_result.m_peak = qMax(m_result.m_peak, qAbs(x));
+
+                double *state = m_state.data() + c * 4;
+                const double y = m_shelf.m_b0 * x + state[0];
+                state[0] = m_shelf.m_b1 * x - m_shelf.m_a1 * y + state[1];
+                state[1] = m_shelf.m_b2 * x - m_shelf.m_a2 * y;
+
+                const double z = m_highpass.m_b0 * y + state[2];
+                state[2] = m_highpass.m_b1 * y - m_highpass.m_a1 * z + state[3];
+                state[3] = m_highpass.m_b2 * y - m_highpass.m_a2 * z;
+
+                m_sum += m_weights[c] * z * z;
+            }
+
+            if(++m_hopCount == m_hop)
+            {
+                addSubBlock();
+            }
+        }
+    }
+
+    inline const MusicLoudnessResult &result() const
+    {
+        return m_result;
+    }
+
+private:
+    struct Biquad
+    {
+        double m_b0, m_b1, m_b2, m_a1, m_a2;
+    };
+
+    void addSubBlock()
+    {
+        // each gating block is 4 sub blocks of 100ms
+        m_blocks[m_blockCount++ % 4] = m_sum;
+        m_sum = 0;
+        m_hopCount = 0;
+
+        if(m_blockCount < 4)
+        {
+            return;
+        }
+
+        const double energy = (m_blocks[0] + m_blocks[1] + m_blocks[2] + m_blocks[3]) / (4.0 * m_hop);
+        if(energy <= 0)
+        {
+            return;
+        }
+
+        const double loudness = energyToLoudness(energy);
+        if(loudness >= LOUDNESS_MIN)
+        {
+            const int index = qMin(TTKStaticCast(int, (loudness - LOUDNESS_MIN) * HISTOGRAM_STEPS), HISTOGRAM_SIZE - 1);
+            ++m_result.m_histogram[index];
+        }
+    }
+
+    int m_channels, m_hop, m_hopCount, m_blockCount;
+    double m_sum;
+    double m_blocks[4];
+    Biquad m_shelf, m_highpass;
+    QVector<double> m_state, m_weights;
+    MusicLoudnessResult m_result;
+
+};
+
+
+static bool analyzeFile(const QString &path, const bool *running, MusicLoudnessResult &result)
+{
+    DecoderFactory *factory = Decoder::findByFilePath(path);
+    if(!factory)
+    {
+        return false;
+    }
+
+    QFile file(path);
+    const bool noInput = factory->properties().noInput;
+    if(!noInput && !file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    Decoder *decoder = factory->create(path, noInput ? nullptr : &file);
+    if(!decoder || !decoder->initialize())
+    {
+        delete decoder;
+        return false;
+    }
+
+    const AudioParameters &parameters = decoder->audioParameters();
+    const int channels = parameters.channels();
+    const int frameSize = parameters.sampleSize() * channels;
+    if(channels <= 0 || frameSize <= 0 || parameters.sampleRate() == 0)
+    {
+        delete decoder;
+        return false;
+    }
+
+    AudioConverter converter;
+    converter.configure(parameters.format());
+    MusicLoudnessMeter meter(parameters.sampleRate(), channels);
+
+    QByteArray buffer(DECODE_BUFFER_SIZE, 0);
+    QVector<float> samples(DECODE_BUFFER_SIZE);
+    qint64 pending = 0;
+
+    while(*running)
+    {
+        const qint64 size = decoder->read(TTKReinterpretCast(unsigned char*, buffer.data()) + pending, buffer.size() - pending);
+        if(size <= 0)
+        {
+            break;
+        }
+
+        // keep the partial frame for next read
+        const qint64 bytes = pending + size;
+        const int frames = bytes / frameSize;
+        converter.toFloat(TTKReinterpretCast(const unsigned char*, buffer.constData()), samples.data(), frames * channels);
+        meter.process(samples.constData(), frames);
+
+        pending = bytes - frames * frameSize;
+        memmove(buffer.data(), buffer.constData() + frames * frameSize, pending);
+    }
+
+    delete decoder;
+    result = meter.result();
+    return *running;
+}
+
+
+/*! @brief The class of the replay gain worker runnable.
+ * @author Greedysky <greedysky@163.com>
+ */
+class MusicReplayGainRunnable : public QRunnable
+{
+public:
+    explicit MusicReplayGainRunnable(const std::function<void()> &func)
+        : m_func(func)
+    {
+
+    }
+
+    virtual void run() override final
+    {
+        m_func();
+    }
+
+private:
+    std::function<void()> m_func;
+
+};
+
+
+MusicReplayGainAnalyzer::MusicReplayGainAnalyzer(QObject *parent)
+    : TTKAbstractThread(parent),
+      m_workerCount(QThread::idealThreadCount()),
+      m_current(0),
+      m_finished(0)
+{
+
+}
+
+void MusicReplayGainAnalyzer::setInputFiles(const QStringList &paths)
+{
+    m_paths = paths;
+}
+
+void MusicReplayGainAnalyzer::setMaxWorkerCount(int count)
+{
+    m_workerCount = qMax(1, count);
+}
+
+void MusicReplayGainAnalyzer::remove(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    m_results.remove(path);
+}
+
+void MusicReplayGainAnalyzer::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_results.clear();
+}
+
+MusicReplayGainItem MusicReplayGainAnalyzer::item(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_results.constFind(path);
+    if(it == m_results.constEnd())
+    {
+        return MusicReplayGainItem();
+    }
+
+    // album loudness is gated over the blocks of all tracks in the same album
+    QVector<quint32> histogram(HISTOGRAM_SIZE, 0);
+    double peak = 0;
+    for(const MusicLoudnessResult &result : qAsConst(m_results))
+    {
+        if(result.m_album != it->m_album)
+        {
+            continue;
+        }
+
+        for(int i = 0; i < HISTOGRAM_SIZE && i < result.m_histogram.count(); ++i)
+        {
+            histogram[i] += result.m_histogram[i];
+        }
+        peak = qMax(peak, result.m_peak);
+    }
+
+    MusicReplayGainItem item;
+    item.m_path = path;
+    item.m_trackGain = replayGain(it->m_histogram);
+    item.m_trackPeak = it->m_peak;
+    item.m_albumGain = replayGain(histogram);
+    item.m_albumPeak = peak;
+    return item;
+}
+
+void MusicReplayGainAnalyzer::run()
+{
+    m_current = 0;
+    m_finished = 0;
+
+    if(m_paths.isEmpty())
+    {
+        Q_EMIT analysisFinished();
+        return;
+    }
+
+    // make sure decoder plugins are loaded on this thread before fan out
+    Decoder::findByFilePath(m_paths.front());
+
+    QThreadPool pool;
+    const int count = qMin(m_workerCount, m_paths.count());
+    pool.setMaxThreadCount(qMax(1, count));
+
+    for(int i = 0; i < count; ++i)
+    {
+        pool.start(new MusicReplayGainRunnable([this]() { analyzeFiles(); }));
+    }
+    pool.waitForDone();
+
+    Q_EMIT analysisFinished();
+}
+
+void MusicReplayGainAnalyzer::analyzeFiles()
+{
+    const int total = m_paths.count();
+    while(m_running)
+    {
+        const int index = m_current.fetchAndAddRelaxed(1);
+        if(index >= total)
+        {
+            break;
+        }
+
+        const QString &path = m_paths[index];
+        MusicLoudnessResult result;
+        const bool state = analyzeFile(path, &m_running, result);
+        if(state)
+        {
+            result.m_album = albumKey(path);
+        }
+
+        m_mutex.lock();
+        if(state)
+        {
+            m_results.insert(path, result);
+        }
+        else
+        {
+            TTK_WARN_STREAM("Replay gain analysis failed" << path);
+        }
+
+        Q_EMIT analysisProgressChanged(++m_finished, total);
+        m_mutex.unlock();
+    }
+}
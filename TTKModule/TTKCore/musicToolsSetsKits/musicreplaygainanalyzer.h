@@ -0,0 +1,112 @@
+#ifndef MUSICREPLAYGAINANALYZER_H
+#define MUSICREPLAYGAINANALYZER_H
+
+/***************************************************************************
+ * This file is part of the TTK Music Player project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <QMutex>
+#include "musicreplaygainindex.h"
+#include "ttkabstractthread.h"
+
+/*! @brief The class of the loudness analysis result.
+ * Gating blocks are kept as a loudness histogram, so that album loudness can be merged from tracks.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct TTK_MODULE_EXPORT MusicLoudnessResult
+{
+    double m_peak;
+    QString m_album;
+    QVector<quint32> m_histogram;
+
+    MusicLoudnessResult() noexcept
+        : m_peak(0)
+    {
+
+    }
+};
+
+
+/*! @brief The class of the replay gain analyzer.
+ * Decode tracks through qmmp decoders and measure EBU R128 integrated loudness
+ * on a bounded worker pool, gains are ReplayGain 2 values relative to -18 LUFS.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicReplayGainAnalyzer : public TTKAbstractThread
+{
+    Q_OBJECT
+    TTK_DECLARE_MODULE(MusicReplayGainAnalyzer)
+public:
+    /*!
+     * Object constructor.
+     */
+    explicit MusicReplayGainAnalyzer(QObject *parent = nullptr);
+
+    /*!
+     * Set input file paths to analyze.
+     */
+    void setInputFiles(const QStringList &paths);
+    /*!
+     * Set max worker count, default is ideal thread count.
+     */
+    void setMaxWorkerCount(int count);
+
+    /*!
+     * Remove analyzed result by file path.
+     */
+    void remove(const QString &path);
+    /*!
+     * Clear all analyzed results.
+     */
+    void clear();
+
+    /*!
+     * Get analyzed gain item by file path, album values are computed over analyzed files of the same album.
+     */
+    MusicReplayGainItem item(const QString &path);
+
+Q_SIGNALS:
+    /*!
+     * Analysis progress changed.
+     */
+    void analysisProgressChanged(int value, int total);
+    /*!
+     * Analysis finished or canceled.
+     */
+    void analysisFinished();
+
+private:
+    /*!
+     * Thread run now.
+     */
+    virtual void run() override final;
+
+    /*!
+     * Worker loop to analyze files.
+     */
+    void analyzeFiles();
+
+    int m_workerCount;
+    QStringList m_paths;
+    QAtomicInt m_current;
+    QMutex m_mutex;
+    int m_finished;
+    QMap<QString, MusicLoudnessResult> m_results;
+
+};
+
+#endif // MUSICREPLAYGAINANALYZER_H
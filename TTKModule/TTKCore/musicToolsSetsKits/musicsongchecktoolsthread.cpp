@@ -1,6 +1,221 @@
 #include "musicsongchecktoolsthread.h"
+#include "musicsonghashindex.h"
 #include "musicsongmeta.h"
 
+#include <QRunnable>
+#include <QThreadPool>
+#include <QCryptographicHash>
+
+#include <qmmp/decoder.h>
+#include <qmmp/decoderfactory.h>
+#include <qmmp/audioconverter.h>
+
+static constexpr int PARTIAL_HASH_SIZE = 64 * 1024;
+static constexpr int FULL_HASH_BUFFER_SIZE = 1024 * 1024;
+static constexpr int FINGERPRINT_BITS = 256;
+static constexpr int FINGERPRINT_DISTANCE = FINGERPRINT_BITS / 10;
+static constexpr int FINGERPRINT_BUFFER_SIZE = 64 * 1024;
+
+/*! @brief The class of the song check tools worker runnable.
+ * @author Greedysky <greedysky@163.com>
+ */
+class MusicSongCheckToolsRunnable : public QRunnable
+{
+public:
+    explicit MusicSongCheckToolsRunnable(const std::function<void()> &func)
+        : m_func(func)
+    {
+
+    }
+
+    virtual void run() override final
+    {
+        m_func();
+    }
+
+private:
+    std::function<void()> m_func;
+
+};
+
+
+/*! @brief The class of the duplicate check file entry.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct MusicDuplicateEntry
+{
+    int m_index;
+    QString m_path;
+    MusicSongHashItem m_hash;
+};
+
+
+static int findRoot(QVector<int> &parents, int index)
+{
+    while(parents[index] != index)
+    {
+        index = parents[index] = parents[parents[index]];
+    }
+    return index;
+}
+
+static void unionRoot(QVector<int> &parents, int a, int b)
+{
+    a = findRoot(parents, a);
+    b = findRoot(parents, b);
+    if(a != b)
+    {
+        parents[qMax(a, b)] = qMin(a, b);
+    }
+}
+
+static QByteArray partialHash(const QString &path, qint64 size)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return {};
+    }
+
+    // head and tail of the file, tags are usually there and audio frames differ quickly
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(file.read(PARTIAL_HASH_SIZE));
+    if(size > 2 * PARTIAL_HASH_SIZE)
+    {
+        file.seek(size - PARTIAL_HASH_SIZE);
+    }
+    hash.addData(file.read(PARTIAL_HASH_SIZE));
+    return hash.result();
+}
+
+static QByteArray fullHash(const QString &path, const bool *running)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return {};
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    while(*running && !file.atEnd())
+    {
+        hash.addData(file.read(FULL_HASH_BUFFER_SIZE));
+    }
+    return *running ? hash.result() : QByteArray();
+}
+
+static bool audioFingerprint(const QString &path, const bool *running, MusicSongHashItem &item)
+{
+    DecoderFactory *factory = Decoder::findByFilePath(path);
+    if(!factory)
+    {
+        return false;
+    }
+
+    QFile file(path);
+    const bool noInput = factory->properties().noInput;
+    if(!noInput && !file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    Decoder *decoder = factory->create(path, noInput ? nullptr : &file);
+    if(!decoder || !decoder->initialize())
+    {
+        delete decoder;
+        return false;
+    }
+
+    const AudioParameters &parameters = decoder->audioParameters();
+    const int channels = parameters.channels();
+    const int frameSize = parameters.sampleSize() * channels;
+    const int blockSize = parameters.sampleRate() / 10;
+    if(channels <= 0 || frameSize <= 0 || blockSize <= 0)
+    {
+        delete decoder;
+        return false;
+    }
+
+    AudioConverter converter;
+    converter.configure(parameters.format());
+
+    QByteArray buffer(FINGERPRINT_BUFFER_SIZE, 0);
+    QVector<float> samples(FINGERPRINT_BUFFER_SIZE);
+    QVector<double> energies;
+    qint64 pending = 0;
+    double energy = 0;
+    int count = 0;
+
+    // loudness envelope of 100ms blocks, robust against bitrate and codec changes
+    while(*running && energies.count() <= FINGERPRINT_BITS)
+    {
+        const qint64 size = decoder->read(TTKReinterpretCast(unsigned char*, buffer.data()) + pending, buffer.size() - pending);
+        if(size <= 0)
+        {
+            break;
+        }
+
+        const qint64 bytes = pending + size;
+        const int frames = bytes / frameSize;
+        converter.toFloat(TTKReinterpretCast(const unsigned char*, buffer.constData()), samples.data(), frames * channels);
+
+        for(int i = 0; i < frames; ++i)
+        {
+            double value = 0;
+            for(int c = 0; c < channels; ++c)
+            {
+                value += samples[i * channels + c];
+            }
+
+            value /= channels;
+            energy += value * value;
+
+            if(++count == blockSize)
+            {
+                energies << energy;
+                energy = 0;
+                count = 0;
+            }
+        }
+
+        pending = bytes - frames * frameSize;
+        memmove(buffer.data(), buffer.constData() + frames * frameSize, pending);
+    }
+
+    item.m_duration = decoder->totalTime();
+    delete decoder;
+
+    if(!*running)
+    {
+        return false;
+    }
+
+    // one bit for each block, set when the envelope rises
+    item.m_fingerprint.fill(0, FINGERPRINT_BITS / 8);
+    for(int i = 0; i + 1 < energies.count() && i < FINGERPRINT_BITS; ++i)
+    {
+        if(energies[i + 1] > energies[i])
+        {
+            item.m_fingerprint[i / 8] = char(item.m_fingerprint[i / 8] | (1 << (i % 8)));
+        }
+    }
+    return true;
+}
+
+static int fingerprintDistance(const QByteArray &a, const QByteArray &b)
+{
+    int distance = 0;
+    for(int i = 0; i < a.size() && i < b.size(); ++i)
+    {
+        uchar v = a[i] ^ b[i];
+        for(; v; v &= v - 1)
+        {
+            ++distance;
+        }
+    }
+    return distance;
+}
+
 MusicSongCheckToolsRenameThread::MusicSongCheckToolsRenameThread(QObject *parent)
     : TTKAbstractThread(parent),
       m_songItems(nullptr),
@@ -30,7 +245,7 @@ void MusicSongCheckToolsRenameThread::run()
                     return;
                 }
 
-                if(!meta.read(song.path()))
+                if(!meta.read(song.path(), true))
                 {
                     continue;
                 }
@@ -63,9 +278,14 @@ void MusicSongCheckToolsRenameThread::run()
 
 
 MusicSongCheckToolsDuplicateThread::MusicSongCheckToolsDuplicateThread(QObject *parent)
-    : TTKAbstractThread(parent)
+    : TTKAbstractThread(parent),
+      m_songItems(nullptr),
+      m_operateMode(TTK::Mode::Check),
+      m_fingerprint(false),
+      m_workerCount(QThread::idealThreadCount()),
+      m_current(0)
 {
-    m_songItems = nullptr;
+
 }
 
 void MusicSongCheckToolsDuplicateThread::setDuplicateSongs(MusicSongList *songs)
@@ -73,15 +293,27 @@ void MusicSongCheckToolsDuplicateThread::setDuplicateSongs(MusicSongList *songs)
     m_songItems = songs;
 }
 
+void MusicSongCheckToolsDuplicateThread::setMaxWorkerCount(int count)
+{
+    m_workerCount = qMax(1, count);
+}
+
 void MusicSongCheckToolsDuplicateThread::run()
 {
     if(m_songItems && !m_songItems->isEmpty())
     {
         if(m_operateMode == TTK::Mode::Check)
         {
-            m_datas.clear();
-            MusicSongMeta meta;
-            for(const MusicSong &song : qAsConst(*m_songItems))
+            findDuplicates();
+            if(!m_running)
+            {
+                Q_EMIT finished(MusicSongCheckToolsDuplicateList());
+                return;
+            }
+        }
+        else
+        {
+            for(const int index : qAsConst(m_itemIDs))
             {
                 if(!m_running)
                 {
@@ -89,30 +321,274 @@ void MusicSongCheckToolsDuplicateThread::run()
                     return;
                 }
 
-                if(!meta.read(song.path()))
+                const MusicSongCheckToolsDuplicate &song = m_datas[index];
+                if(QFile::remove(song.m_song.path()))
                 {
-                    continue;
+                    G_SONGHASH_INDEX_PTR->remove(song.m_song.path());
                 }
-
-                m_datas << MusicSongCheckToolsDuplicate(song, meta.bitrate());
             }
+            G_SONGHASH_INDEX_PTR->save();
+        }
+    }
+    Q_EMIT finished(m_datas);
+}
+
+void MusicSongCheckToolsDuplicateThread::findDuplicates()
+{
+    m_datas.clear();
+
+    // size stage, files of unique size can not be byte identical
+    QVector<MusicDuplicateEntry> entries;
+    QHash<qint64, TTKIntList> sizes;
+    for(int i = 0; i < m_songItems->count() && m_running; ++i)
+    {
+        const QString &path = m_songItems->at(i).path();
+        const QFileInfo fin(path);
+        if(!fin.isFile())
+        {
+            continue;
+        }
+
+        MusicDuplicateEntry entry;
+        entry.m_index = i;
+        entry.m_path = path;
+        if(!G_SONGHASH_INDEX_PTR->find(path, fin.size(), fin.lastModified().toMSecsSinceEpoch(), entry.m_hash))
+        {
+            entry.m_hash = MusicSongHashItem();
+            entry.m_hash.m_size = fin.size();
+            entry.m_hash.m_lastModified = fin.lastModified().toMSecsSinceEpoch();
+        }
+
+        sizes[entry.m_hash.m_size] << entries.count();
+        entries << entry;
+    }
+
+    QVector<int> parents(entries.count());
+    for(int i = 0; i < parents.count(); ++i)
+    {
+        parents[i] = i;
+    }
+
+    TTKIntList candidates;
+    for(auto it = sizes.constBegin(); it != sizes.constEnd(); ++it)
+    {
+        if(it.value().count() > 1)
+        {
+            candidates << it.value();
+        }
+    }
+
+    // partial hash stage
+    parallelFor(candidates.count(), [&](int i) {
+        MusicSongHashItem &hash = entries[candidates[i]].m_hash;
+        if(hash.m_partialHash.isEmpty())
+        {
+            hash.m_partialHash = partialHash(entries[candidates[i]].m_path, hash.m_size);
+        }
+    });
+
+    QHash<QByteArray, TTKIntList> partials;
+    for(const int index : qAsConst(candidates))
+    {
+        const MusicSongHashItem &hash = entries[index].m_hash;
+        if(!hash.m_partialHash.isEmpty())
+        {
+            partials[hash.m_partialHash + QByteArray::number(hash.m_size)] << index;
+        }
+    }
+
+    candidates.clear();
+    for(auto it = partials.constBegin(); it != partials.constEnd(); ++it)
+    {
+        if(it.value().count() > 1)
+        {
+            candidates << it.value();
+        }
+    }
+
+    // full hash stage, small files are already covered by partial hash
+    parallelFor(candidates.count(), [&](int i) {
+        MusicSongHashItem &hash = entries[candidates[i]].m_hash;
+        if(hash.m_fullHash.isEmpty())
+        {
+            hash.m_fullHash = hash.m_size <= 2 * PARTIAL_HASH_SIZE ? hash.m_partialHash : fullHash(entries[candidates[i]].m_path, &m_running);
+        }
+    });
+
+    QHash<QByteArray, int> fulls;
+    for(const int index : qAsConst(candidates))
+    {
+        const MusicSongHashItem &hash = entries[index].m_hash;
+        if(hash.m_fullHash.isEmpty())
+        {
+            continue;
+        }
+
+        const QByteArray &key = hash.m_fullHash + QByteArray::number(hash.m_size);
+        const auto it = fulls.constFind(key);
+        if(it == fulls.constEnd())
+        {
+            fulls.insert(key, index);
         }
         else
         {
-            for(const int index : qAsConst(m_itemIDs))
+            unionRoot(parents, it.value(), index);
+        }
+    }
+
+    // fingerprint stage, only one file of each identical group is decoded
+    if(m_fingerprint && m_running)
+    {
+        // only songs whose playlist duration is within a second of another one are decoded
+        QHash<qint64, int> seconds;
+        for(int i = 0; i < entries.count(); ++i)
+        {
+            const qint64 duration = m_songItems->at(entries[i].m_index).durationValue() / TTK_DN_S2MS;
+            if(findRoot(parents, i) == i && duration > 0)
             {
-                if(!m_running)
+                ++seconds[duration];
+            }
+        }
+
+        candidates.clear();
+        for(int i = 0; i < entries.count(); ++i)
+        {
+            const qint64 duration = m_songItems->at(entries[i].m_index).durationValue() / TTK_DN_S2MS;
+            if(findRoot(parents, i) != i || duration <= 0)
+            {
+                continue;
+            }
+
+            if(seconds.value(duration - 1) + seconds.value(duration) + seconds.value(duration + 1) > 1)
+            {
+                candidates << i;
+            }
+        }
+
+        Decoder::findByFilePath(entries.isEmpty() ? QString() : entries.front().m_path);
+        parallelFor(candidates.count(), [&](int i) {
+            MusicSongHashItem &hash = entries[candidates[i]].m_hash;
+            if(hash.m_fingerprint.isEmpty())
+            {
+                audioFingerprint(entries[candidates[i]].m_path, &m_running, hash);
+            }
+        });
+
+        QMap<qint64, TTKIntList> durations;
+        for(const int index : qAsConst(candidates))
+        {
+            const MusicSongHashItem &hash = entries[index].m_hash;
+            if(!hash.m_fingerprint.isEmpty() && hash.m_duration > 0)
+            {
+                durations[qRound64(hash.m_duration / 1000.0)] << index;
+            }
+        }
+
+        // compare with the same and next second bucket, re-encoded copies differ in padding
+        for(auto it = durations.constBegin(); it != durations.constEnd() && m_running; ++it)
+        {
+            TTKIntList indexs = it.value();
+            const auto next = durations.constFind(it.key() + 1);
+            const int count = indexs.count();
+            if(next != durations.constEnd())
+            {
+                indexs << next.value();
+            }
+
+            for(int i = 0; i < count; ++i)
+            {
+                for(int j = i + 1; j < indexs.count(); ++j)
                 {
-                    Q_EMIT finished(MusicSongCheckToolsDuplicateList());
-                    return;
+                    const MusicDuplicateEntry &a = entries[indexs[i]];
+                    const MusicDuplicateEntry &b = entries[indexs[j]];
+                    if(fingerprintDistance(a.m_hash.m_fingerprint, b.m_hash.m_fingerprint) <= FINGERPRINT_DISTANCE)
+                    {
+                        unionRoot(parents, indexs[i], indexs[j]);
+                    }
                 }
-
-                const MusicSongCheckToolsDuplicate &song = m_datas[index];
-                QFile::remove(song.m_song.path());
             }
         }
     }
-    Q_EMIT finished(m_datas);
+
+    if(!m_running)
+    {
+        return;
+    }
+
+    for(const MusicDuplicateEntry &entry : qAsConst(entries))
+    {
+        G_SONGHASH_INDEX_PTR->insert(entry.m_path, entry.m_hash);
+    }
+    // drop entries of files deleted or moved outside the player
+    G_SONGHASH_INDEX_PTR->purge();
+    G_SONGHASH_INDEX_PTR->save();
+
+    QMap<int, TTKIntList> groups;
+    for(int i = 0; i < entries.count(); ++i)
+    {
+        groups[findRoot(parents, i)] << i;
+    }
+
+    TTKIntList founds;
+    for(auto it = groups.constBegin(); it != groups.constEnd(); ++it)
+    {
+        if(it.value().count() > 1)
+        {
+            founds << it.value();
+        }
+    }
+
+    // only duplicated songs need meta for bitrate
+    QVector<QString> bitrates(founds.count());
+    parallelFor(founds.count(), [&](int i) {
+        MusicSongMeta meta;
+        if(meta.read(entries[founds[i]].m_path, true))
+        {
+            bitrates[i] = meta.bitrate();
+        }
+    });
+
+    int group = -1, root = -1;
+    for(int i = 0; i < founds.count(); ++i)
+    {
+        const int index = founds[i];
+        if(findRoot(parents, index) != root)
+        {
+            root = findRoot(parents, index);
+            ++group;
+        }
+        m_datas << MusicSongCheckToolsDuplicate(m_songItems->at(entries[index].m_index), bitrates[i], group);
+    }
+}
+
+void MusicSongCheckToolsDuplicateThread::parallelFor(int count, const std::function<void(int)> &func)
+{
+    if(count <= 0 || !m_running)
+    {
+        return;
+    }
+
+    m_current = 0;
+
+    QThreadPool pool;
+    const int workers = qMin(m_workerCount, count);
+    pool.setMaxThreadCount(qMax(1, workers));
+
+    for(int i = 0; i < workers; ++i)
+    {
+        pool.start(new MusicSongCheckToolsRunnable([this, count, &func]() {
+            while(m_running)
+            {
+                const int index = m_current.fetchAndAddRelaxed(1);
+                if(index >= count)
+                {
+                    break;
+                }
+                func(index);
+            }
+        }));
+    }
+    pool.waitForDone();
 }
 
 
@@ -142,7 +618,7 @@ void MusicSongCheckToolsQualityThread::run()
                 return;
             }
 
-            if(!meta.read(song.path()))
+            if(!meta.read(song.path(), true))
             {
                 continue;
             }
@@ -19,6 +19,7 @@
  * with this program; If not, see <http://www.gnu.org/licenses/>.
  ***************************************************************************/
 
+#include <functional>
 #include "ttkabstractthread.h"
 #include "musicsongchecktoolsunit.h"
 
@@ -74,6 +75,8 @@ private:
 
 
 /*! @brief The class of the song check tools duplicate thread.
+ * Songs are narrowed by file size, partial content hash and full content hash,
+ * re-encoded copies are matched by duration and audio fingerprint optionally.
  * @author Greedysky <greedysky@163.com>
  */
 class TTK_MODULE_EXPORT MusicSongCheckToolsDuplicateThread : public TTKAbstractThread
@@ -103,6 +106,14 @@ public:
      * Set find file path by given path.
      */
     void setDuplicateSongs(MusicSongList *songs);
+    /*!
+     * Set audio fingerprint match enable or disable.
+     */
+    inline void setFingerprintEnabled(bool enabled) { m_fingerprint = enabled; }
+    /*!
+     * Set max worker count, default is ideal thread count.
+     */
+    void setMaxWorkerCount(int count);
 
 Q_SIGNALS:
     /*!
@@ -116,10 +127,22 @@ private:
      */
     virtual void run() override final;
 
+    /*!
+     * Find duplicate songs by multi stage.
+     */
+    void findDuplicates();
+    /*!
+     * Run the given work for each index on worker pool.
+     */
+    void parallelFor(int count, const std::function<void(int)> &func);
+
     MusicSongList *m_songItems;
     TTKIntList m_itemIDs;
     MusicSongCheckToolsDuplicateList m_datas;
     TTK::Mode m_operateMode;
+    bool m_fingerprint;
+    int m_workerCount;
+    QAtomicInt m_current;
 
 };
 
@@ -60,10 +60,12 @@ struct TTK_MODULE_EXPORT MusicSongCheckToolsDuplicate
 {
     MusicSong m_song;
     QString m_bitrate;
+    int m_group;
 
-    MusicSongCheckToolsDuplicate(const MusicSong &song, const QString &bitrate)
+    MusicSongCheckToolsDuplicate(const MusicSong &song, const QString &bitrate, int group = -1)
         : m_song(song),
-          m_bitrate(bitrate)
+          m_bitrate(bitrate),
+          m_group(group)
     {
 
     }
@@ -0,0 +1,173 @@
+#include "musicsongimportthread.h"
+#include "musicfileutils.h"
+#include "musicformats.h"
+
+#include <functional>
+#include <QRunnable>
+#include <QThreadPool>
+
+static constexpr int IMPORT_BATCH_SIZE = 200;
+
+/*! @brief The class of the songs import worker runnable.
+ * @author Greedysky <greedysky@163.com>
+ */
+class MusicSongImportRunnable : public QRunnable
+{
+public:
+    explicit MusicSongImportRunnable(const std::function<void()> &func)
+        : m_func(func)
+    {
+
+    }
+
+    virtual void run() override final
+    {
+        m_func();
+    }
+
+private:
+    std::function<void()> m_func;
+
+};
+
+
+MusicSongImportThread::MusicSongImportThread(QObject *parent)
+    : TTKAbstractThread(parent),
+      m_workerCount(QThread::idealThreadCount()),
+      m_batchSize(IMPORT_BATCH_SIZE),
+      m_current(0),
+      m_finished(0),
+      m_cursor(0)
+{
+    Q_UNUSED(qRegisterMetaType<MusicSongList>("MusicSongList"));
+}
+
+void MusicSongImportThread::setImportFilePath(const QStringList &path)
+{
+    m_path = path;
+}
+
+void MusicSongImportThread::setMaxWorkerCount(int count)
+{
+    m_workerCount = qMax(1, count);
+}
+
+void MusicSongImportThread::setBatchSize(int size)
+{
+    m_batchSize = qMax(1, size);
+}
+
+void MusicSongImportThread::run()
+{
+    m_files.clear();
+    m_results.clear();
+    m_ready.clear();
+    m_batch.clear();
+    m_current = 0;
+    m_finished = 0;
+    m_cursor = 0;
+
+    // discover stage
+    QSet<QString> founds;
+    const QStringList &filter = MusicFormats::supportMusicInputFilterFormats();
+    for(const QString &path : qAsConst(m_path))
+    {
+        if(!m_running)
+        {
+            break;
+        }
+
+        const QFileInfo fin(path);
+        const QStringList &files = fin.isDir() ? TTK::File::fileListByPath(path, filter) : QStringList(fin.absoluteFilePath());
+
+        for(const QString &file : qAsConst(files))
+        {
+            if(!founds.contains(file) && MusicFormats::supportMusicFormats().contains(TTK_FILE_SUFFIX(QFileInfo(file))))
+            {
+                founds.insert(file);
+                m_files << file;
+            }
+        }
+    }
+
+    if(!m_running || m_files.isEmpty())
+    {
+        Q_EMIT importFinished();
+        return;
+    }
+
+    for(int i = 0; i < m_files.count(); ++i)
+    {
+        m_results << MusicSongList();
+        m_ready << false;
+    }
+
+    // read the first file on this thread, so that decoder plugins cache is ready before fan out
+    m_current = 1;
+    appendSongs(0, TTK::generateSongList(m_files.front()));
+
+    // read tags stage
+    QThreadPool pool;
+    const int count = qMin(m_workerCount, m_files.count() - 1);
+    pool.setMaxThreadCount(qMax(1, count));
+
+    for(int i = 0; i < count; ++i)
+    {
+        pool.start(new MusicSongImportRunnable([this]() { readSongs(); }));
+    }
+    pool.waitForDone();
+
+    // build songs stage
+    flushSongs(true);
+    Q_EMIT importFinished();
+}
+
+void MusicSongImportThread::readSongs()
+{
+    const int total = m_files.count();
+    while(m_running)
+    {
+        const int index = m_current.fetchAndAddRelaxed(1);
+        if(index >= total)
+        {
+            break;
+        }
+
+        appendSongs(index, TTK::generateSongList(m_files[index]));
+    }
+}
+
+void MusicSongImportThread::appendSongs(int index, const MusicSongList &songs)
+{
+    m_mutex.lock();
+    m_results[index] = songs;
+    m_ready[index] = true;
+    ++m_finished;
+
+    while(m_cursor < m_ready.count() && m_ready[m_cursor])
+    {
+        m_batch << m_results[m_cursor];
+        m_results[m_cursor].clear();
+        ++m_cursor;
+    }
+
+    Q_EMIT importProgressChanged(m_finished, m_files.count());
+    m_mutex.unlock();
+
+    flushSongs(false);
+}
+
+void MusicSongImportThread::flushSongs(bool force)
+{
+    m_mutex.lock();
+    if(m_batch.isEmpty() || (!force && m_batch.count() < m_batchSize) || !m_running)
+    {
+        m_mutex.unlock();
+        return;
+    }
+
+    // emit under lock to keep batches in input order, queued connection only posts the event
+    Q_EMIT importSongsChanged(m_batch);
+    m_batch.clear();
+    m_mutex.unlock();
+}
@@ -0,0 +1,98 @@
+#ifndef MUSICSONGIMPORTTHREAD_H
+#define MUSICSONGIMPORTTHREAD_H
+
+/***************************************************************************
+ * This file is part of the TTK Music Player project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <QMutex>
+#include "musicsong.h"
+#include "ttkabstractthread.h"
+
+/*! @brief The class of the songs import thread.
+ * Discover files, read tags and build songs on a bounded worker pool,
+ * results are streamed back in input order by batches.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicSongImportThread : public TTKAbstractThread
+{
+    Q_OBJECT
+    TTK_DECLARE_MODULE(MusicSongImportThread)
+public:
+    /*!
+     * Object constructor.
+     */
+    explicit MusicSongImportThread(QObject *parent = nullptr);
+
+    /*!
+     * Set import file or dir path by given path list.
+     */
+    void setImportFilePath(const QStringList &path);
+    /*!
+     * Set max worker count, default is ideal thread count.
+     */
+    void setMaxWorkerCount(int count);
+    /*!
+     * Set songs count of each result batch.
+     */
+    void setBatchSize(int size);
+
+Q_SIGNALS:
+    /*!
+     * Import progress changed.
+     */
+    void importProgressChanged(int value, int total);
+    /*!
+     * Send the imported songs batch.
+     */
+    void importSongsChanged(const MusicSongList &songs);
+    /*!
+     * Import finished or canceled.
+     */
+    void importFinished();
+
+private:
+    /*!
+     * Thread run now.
+     */
+    virtual void run() override final;
+
+    /*!
+     * Worker loop to read file meta.
+     */
+    void readSongs();
+    /*!
+     * Append current worker result and flush ordered batch.
+     */
+    void appendSongs(int index, const MusicSongList &songs);
+    /*!
+     * Flush all pending ordered songs.
+     */
+    void flushSongs(bool force);
+
+    QStringList m_path, m_files;
+    int m_workerCount, m_batchSize;
+    QAtomicInt m_current;
+    QMutex m_mutex;
+    int m_finished, m_cursor;
+    QList<MusicSongList> m_results;
+    QList<bool> m_ready;
+    MusicSongList m_batch;
+
+};
+
+#endif // MUSICSONGIMPORTTHREAD_H
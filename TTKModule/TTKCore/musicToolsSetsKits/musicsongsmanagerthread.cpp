@@ -1,6 +1,12 @@
 #include "musicsongsmanagerthread.h"
 #include "musicfileutils.h"
 #include "musicformats.h"
+#include "musiccoreutils.h"
+
+#include <QDateTime>
+
+// directory modified time within this window may be racy on coarse timestamp file system
+static constexpr int RACY_MODIFIED_TIME = 2 * TTK_DN_S2MS;
 
 MusicSongsManagerThread::MusicSongsManagerThread(QObject *parent)
     : TTKAbstractThread(parent)
@@ -18,6 +24,11 @@ void MusicSongsManagerThread::setFindFilePath(const QStringList &path)
     m_path = path;
 }
 
+void MusicSongsManagerThread::clearSnapshot()
+{
+    m_snapshots.clear();
+}
+
 void MusicSongsManagerThread::run()
 {
     QStringList list;
@@ -25,9 +36,107 @@ void MusicSongsManagerThread::run()
     {
         if(m_running)
         {
-            list << TTK::File::fileListByPath(path, MusicFormats::supportMusicInputFilterFormats());
+            const QString &dir = QDir(path).absolutePath();
+            scanDirectory(dir);
+            collectFiles(dir, list);
         }
     }
+
     ///The name and path search ended when sending the corresponding
     Q_EMIT searchFilePathChanged(list);
 }
+
+void MusicSongsManagerThread::scanDirectory(const QString &path)
+{
+    if(!m_running || TTK::Core::isBreakPointEnabled())
+    {
+        return;
+    }
+
+    const QFileInfo fin(path);
+    if(!fin.isDir())
+    {
+        removeDirectory(path);
+        return;
+    }
+
+    const qint64 lastModified = fin.lastModified().toMSecsSinceEpoch();
+    MusicSongsDirectorySnapshot &snapshot = m_snapshots[path];
+
+    // directory entries are unchanged, only descend into sub directories
+    if(snapshot.m_lastModified == lastModified && lastModified + RACY_MODIFIED_TIME < snapshot.m_scanTime)
+    {
+        const QStringList dirs(snapshot.m_dirs);
+        for(const QString &dir : qAsConst(dirs))
+        {
+            scanDirectory(dir);
+        }
+        return;
+    }
+
+    const QDir dir(path);
+    const QString &spr = path.endsWith(TTK_SEPARATOR) ? QString() : TTK_SEPARATOR;
+
+    QStringList files;
+    for(const QFileInfo &file : dir.entryInfoList(MusicFormats::supportMusicInputFilterFormats(), QDir::Files | QDir::Hidden))
+    {
+        files << path + spr + file.fileName();
+    }
+
+    QStringList dirs;
+    for(const QFileInfo &file : dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        dirs << file.absoluteFilePath();
+    }
+
+    const QStringList lastDirs(snapshot.m_dirs);
+    snapshot.m_lastModified = lastModified;
+    snapshot.m_scanTime = QDateTime::currentMSecsSinceEpoch();
+    snapshot.m_dirs = dirs;
+    snapshot.m_files = files;
+
+    for(const QString &dir : qAsConst(lastDirs))
+    {
+        if(!dirs.contains(dir))
+        {
+            removeDirectory(dir);
+        }
+    }
+
+    for(const QString &dir : qAsConst(dirs))
+    {
+        scanDirectory(dir);
+    }
+}
+
+void MusicSongsManagerThread::removeDirectory(const QString &path)
+{
+    const auto it = m_snapshots.find(path);
+    if(it == m_snapshots.end())
+    {
+        return;
+    }
+
+    const QStringList dirs(it->m_dirs);
+    m_snapshots.erase(it);
+
+    for(const QString &dir : qAsConst(dirs))
+    {
+        removeDirectory(dir);
+    }
+}
+
+void MusicSongsManagerThread::collectFiles(const QString &path, QStringList &files) const
+{
+    const auto it = m_snapshots.constFind(path);
+    if(it == m_snapshots.constEnd())
+    {
+        return;
+    }
+
+    files << it->m_files;
+    for(const QString &dir : qAsConst(it->m_dirs))
+    {
+        collectFiles(dir, files);
+    }
+}
@@ -19,8 +19,27 @@
  * with this program; If not, see <http://www.gnu.org/licenses/>.
  ***************************************************************************/
 
+#include <QHash>
 #include "ttkabstractthread.h"
 
+/*! @brief The class of the songs directory snapshot.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct TTK_MODULE_EXPORT MusicSongsDirectorySnapshot
+{
+    qint64 m_lastModified;
+    qint64 m_scanTime;
+    QStringList m_dirs;
+    QStringList m_files;
+
+    MusicSongsDirectorySnapshot() noexcept
+        : m_lastModified(-1),
+          m_scanTime(-1)
+    {
+
+    }
+};
+
 /*! @brief The class of the songs manager thread.
  * @author Greedysky <greedysky@163.com>
  */
@@ -43,6 +62,11 @@ public:
      */
     void setFindFilePath(const QStringList &path);
 
+    /*!
+     * Clear all directory snapshots, next run will rescan everything.
+     */
+    void clearSnapshot();
+
 Q_SIGNALS:
     /*!
      * Send the searched file or path.
@@ -55,7 +79,21 @@ private:
      */
     virtual void run() override final;
 
+    /*!
+     * Scan directory incrementally, only list the directory that changed.
+     */
+    void scanDirectory(const QString &path);
+    /*!
+     * Remove directory snapshot recursively.
+     */
+    void removeDirectory(const QString &path);
+    /*!
+     * Collect files from directory snapshot recursively.
+     */
+    void collectFiles(const QString &path, QStringList &files) const;
+
     QStringList m_path;
+    QHash<QString, MusicSongsDirectorySnapshot> m_snapshots;
 
 };
 
@@ -0,0 +1,188 @@
+#include "musictranscodescheduler.h"
+
+#include <QThread>
+
+static qint64 parseTime(const QString &text, const QString &key)
+{
+    // ffmpeg prints duration and position as hh:mm:ss.xx
+    const QRegExp regx(key + "\\s*(\\d+):(\\d+):(\\d+)\\.(\\d+)");
+    if(regx.indexIn(text) == -1)
+    {
+        return -1;
+    }
+
+    const qint64 second = regx.cap(1).toLongLong() * 3600 + regx.cap(2).toLongLong() * 60 + regx.cap(3).toLongLong();
+    return second * TTK_DN_S2MS + regx.cap(4).left(3).leftJustified(3, '0').toLongLong();
+}
+
+
+MusicTranscodeScheduler::MusicTranscodeScheduler(QObject *parent)
+    : QObject(parent),
+      m_workerCount(QThread::idealThreadCount()),
+      m_retryCount(1),
+      m_nextId(0)
+{
+
+}
+
+MusicTranscodeScheduler::~MusicTranscodeScheduler()
+{
+    cancel();
+}
+
+void MusicTranscodeScheduler::setMaxWorkerCount(int count)
+{
+    m_workerCount = qMax(1, count);
+}
+
+void MusicTranscodeScheduler::setRetryCount(int count)
+{
+    m_retryCount = qMax(0, count);
+}
+
+int MusicTranscodeScheduler::addJob(const QString &input, const QStringList &arguments)
+{
+    MusicTranscodeJob job;
+    job.m_id = m_nextId++;
+    job.m_input = input;
+    job.m_arguments = arguments;
+    m_pending << job;
+    return job.m_id;
+}
+
+void MusicTranscodeScheduler::start()
+{
+    if(!isRunning())
+    {
+        Q_EMIT finished();
+        return;
+    }
+
+    m_failed.clear();
+    startJobs();
+}
+
+void MusicTranscodeScheduler::cancel()
+{
+    m_pending.clear();
+
+    if(m_running.isEmpty())
+    {
+        return;
+    }
+
+    for(auto it = m_running.constBegin(); it != m_running.constEnd(); ++it)
+    {
+        QProcess *process = it.key();
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished();
+        delete process;
+    }
+
+    m_running.clear();
+    Q_EMIT finished();
+}
+
+bool MusicTranscodeScheduler::isRunning() const
+{
+    return !m_pending.isEmpty() || !m_running.isEmpty();
+}
+
+QStringList MusicTranscodeScheduler::failedFiles() const
+{
+    return m_failed;
+}
+
+void MusicTranscodeScheduler::processReadyRead()
+{
+    QProcess *process = TTKObjectCast(QProcess*, sender());
+    const auto it = m_running.find(process);
+    if(it == m_running.end())
+    {
+        return;
+    }
+
+    // progress lines are ended by carriage return, so only the last position in this read is used
+    const QString &text = QString::fromLocal8Bit(process->readAll());
+    if(it->m_duration <= 0)
+    {
+        it->m_duration = parseTime(text, "Duration:");
+    }
+
+    const int index = text.lastIndexOf("time=");
+    const qint64 position = index == -1 ? -1 : parseTime(text.mid(index), "time=");
+    if(it->m_duration > 0 && position >= 0)
+    {
+        Q_EMIT jobProgressChanged(it->m_id, qBound(0, TTKStaticCast(int, position * 100 / it->m_duration), 100));
+    }
+}
+
+void MusicTranscodeScheduler::processFinished(int code)
+{
+    QProcess *process = TTKObjectCast(QProcess*, sender());
+    finishJob(process, code == 0 && process->exitStatus() == QProcess::NormalExit, code);
+}
+
+void MusicTranscodeScheduler::processError(QProcess::ProcessError error)
+{
+    // the process never emits finished when it failed to start
+    if(error == QProcess::FailedToStart)
+    {
+        finishJob(TTKObjectCast(QProcess*, sender()), false, -1);
+    }
+}
+
+void MusicTranscodeScheduler::finishJob(QProcess *process, bool state, int code)
+{
+    if(!m_running.contains(process))
+    {
+        return;
+    }
+
+    MusicTranscodeJob job = m_running.take(process);
+    process->disconnect(this);
+    process->deleteLater();
+
+    if(state)
+    {
+        Q_EMIT jobProgressChanged(job.m_id, 100);
+        Q_EMIT jobFinished(job.m_id, true);
+    }
+    else if(job.m_retry++ < m_retryCount)
+    {
+        TTK_WARN_STREAM("Transcode job failed, retry" << job.m_retry << job.m_input);
+        job.m_duration = 0;
+        m_pending << job;
+    }
+    else
+    {
+        TTK_ERROR_STREAM("Transcode job failed" << job.m_input << "exit code" << code);
+        m_failed << job.m_input;
+        Q_EMIT jobFinished(job.m_id, false);
+    }
+
+    startJobs();
+}
+
+void MusicTranscodeScheduler::startJobs()
+{
+    while(!m_pending.isEmpty() && m_running.count() < m_workerCount)
+    {
+        const MusicTranscodeJob &job = m_pending.takeFirst();
+
+        QProcess *process = new QProcess(this);
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        connect(process, SIGNAL(readyRead()), SLOT(processReadyRead()));
+        connect(process, SIGNAL(finished(int)), SLOT(processFinished(int)));
+        QtProcessConnect(process, this, processError, SLOT);
+
+        m_running.insert(process, job);
+        process->start(MAKE_TRANSFORM_PATH_FULL, job.m_arguments);
+    }
+
+    if(m_running.isEmpty())
+    {
+        Q_EMIT finished();
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef MUSICTRANSCODESCHEDULER_H
+#define MUSICTRANSCODESCHEDULER_H
+
+/***************************************************************************
+ * This file is part of the TTK Music Player project
+ * Copyright (C) 2015 - 2025 Greedysky Studio
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+
+#include <QProcess>
+#include "musicglobaldefine.h"
+
+/*! @brief The class of the transcode job item.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct TTK_MODULE_EXPORT MusicTranscodeJob
+{
+    int m_id;
+    int m_retry;
+    qint64 m_duration;
+    QString m_input;
+    QStringList m_arguments;
+
+    MusicTranscodeJob() noexcept
+        : m_id(-1),
+          m_retry(0),
+          m_duration(0)
+    {
+
+    }
+};
+
+
+/*! @brief The class of the transcode job scheduler.
+ * Run transform plugin processes for queued jobs, at most worker count processes at the same time.
+ * @author Greedysky <greedysky@163.com>
+ */
+class TTK_MODULE_EXPORT MusicTranscodeScheduler : public QObject
+{
+    Q_OBJECT
+    TTK_DECLARE_MODULE(MusicTranscodeScheduler)
+public:
+    /*!
+     * Object constructor.
+     */
+    explicit MusicTranscodeScheduler(QObject *parent = nullptr);
+    /*!
+     * Object destructor.
+     */
+    ~MusicTranscodeScheduler();
+
+    /*!
+     * Set max worker process count, default is ideal thread count.
+     */
+    void setMaxWorkerCount(int count);
+    /*!
+     * Set retry count of failed job, default is 1.
+     */
+    void setRetryCount(int count);
+
+    /*!
+     * Add transcode job by input file and plugin arguments, return the job id.
+     */
+    int addJob(const QString &input, const QStringList &arguments);
+    /*!
+     * Start to run queued jobs.
+     */
+    void start();
+    /*!
+     * Cancel queued and running jobs.
+     */
+    void cancel();
+    /*!
+     * Check whether there are jobs queued or running.
+     */
+    bool isRunning() const;
+
+    /*!
+     * Get input files of failed jobs.
+     */
+    QStringList failedFiles() const;
+
+Q_SIGNALS:
+    /*!
+     * Job transcode progress changed.
+     */
+    void jobProgressChanged(int id, int percent);
+    /*!
+     * Job finished or failed after retry.
+     */
+    void jobFinished(int id, bool state);
+    /*!
+     * All jobs finished or canceled.
+     */
+    void finished();
+
+private Q_SLOTS:
+    /*!
+     * Read process output to parse progress.
+     */
+    void processReadyRead();
+    /*!
+     * Process finished.
+     */
+    void processFinished(int code);
+    /*!
+     * Process error occurred.
+     */
+    void processError(QProcess::ProcessError error);
+
+private:
+    /*!
+     * Start queued jobs by free workers.
+     */
+    void startJobs();
+    /*!
+     * Finish running job of process, failed job is queued again until retry count reached.
+     */
+    void finishJob(QProcess *process, bool state, int code);
+
+    int m_workerCount, m_retryCount, m_nextId;
+    QList<MusicTranscodeJob> m_pending;
+    QMap<QProcess*, MusicTranscodeJob> m_running;
+    QStringList m_failed;
+
+};
+
+#endif // MUSICTRANSCODESCHEDULER_H
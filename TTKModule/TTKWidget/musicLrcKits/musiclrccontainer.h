@@ -57,6 +57,11 @@ public:
      * Subclass should implement this function.
      */
     virtual void stopDrawLrc() = 0;
+    /*!
+     * Sync lrc mask by elapsed play time of current line.
+     * Subclass should implement this function.
+     */
+    virtual void setDrawLrcPosition(qint64 elapsed) = 0;
     /*!
      * Set setting parameter.
      */
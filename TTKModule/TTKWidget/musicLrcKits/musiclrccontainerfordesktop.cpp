@@ -44,6 +44,11 @@ void MusicLrcContainerForDesktop::stopDrawLrc()
     }
 }
 
+void MusicLrcContainerForDesktop::setDrawLrcPosition(qint64 elapsed)
+{
+    m_lrcManagers[m_singleLine ? 0 : !m_reverse]->setDrawLrcPosition(elapsed);
+}
+
 void MusicLrcContainerForDesktop::applyParameter()
 {
     MusicLrcContainer::applyParameter();
@@ -89,6 +89,11 @@ void MusicLrcContainerForInterior::stopDrawLrc()
     m_layoutWidget->stop();
 }
 
+void MusicLrcContainerForInterior::setDrawLrcPosition(qint64 elapsed)
+{
+    m_lrcManagers[m_lrcAnalysis->lineMiddle()]->setDrawLrcPosition(elapsed);
+}
+
 void MusicLrcContainerForInterior::applyParameter()
 {
     MusicLrcContainer::applyParameter();
@@ -53,6 +53,10 @@ public:
      * Stop timer clock to draw lrc.
      */
     virtual void stopDrawLrc() override final;
+    /*!
+     * Sync lrc mask by elapsed play time of current line.
+     */
+    virtual void setDrawLrcPosition(qint64 elapsed) override final;
     /*!
      * Set setting parameter.
      */
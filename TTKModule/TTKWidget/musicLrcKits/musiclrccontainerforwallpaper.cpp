@@ -54,6 +54,11 @@ void MusicLrcContainerForWallpaper::stopDrawLrc()
     m_layoutWidget->stop();
 }
 
+void MusicLrcContainerForWallpaper::setDrawLrcPosition(qint64 elapsed)
+{
+    m_lrcManagers[MUSIC_LRC_INTERIOR_MAX_LINE / 2]->setDrawLrcPosition(elapsed);
+}
+
 void MusicLrcContainerForWallpaper::applyParameter()
 {
     const int width = G_SETTING_PTR->value(MusicSettingManager::ScreenSize).toSize().width() - LRC_PER_WIDTH;
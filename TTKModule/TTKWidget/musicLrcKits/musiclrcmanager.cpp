@@ -1,8 +1,60 @@
 #include "musiclrcmanager.h"
+#include "musicsettingmanager.h"
 #include "musicwidgetutils.h"
 
+#include <QPointer>
+#include <QApplication>
 #include <QFontDatabase>
 
+/*! @brief The class of the lrc shared frame ticker.
+ * @author Greedysky <greedysky@163.com>
+ */
+class MusicLrcTicker
+{
+public:
+    /*!
+     * Attach receiver to frame tick, start tick when the first one attached.
+     */
+    static void attach(QObject *receiver)
+    {
+        QTimer *timer = instance();
+        if(QObject::connect(timer, SIGNAL(timeout()), receiver, SLOT(updateMask()), Qt::UniqueConnection) && ++m_count == 1)
+        {
+            timer->start();
+        }
+    }
+    /*!
+     * Detach receiver from frame tick, stop tick when the last one detached.
+     */
+    static void detach(QObject *receiver)
+    {
+        QTimer *timer = instance();
+        if(timer && QObject::disconnect(timer, SIGNAL(timeout()), receiver, SLOT(updateMask())) && --m_count == 0)
+        {
+            timer->stop();
+        }
+    }
+
+private:
+    static QTimer *instance()
+    {
+        static QPointer<QTimer> timer;
+        if(!timer && qApp)
+        {
+            timer = new QTimer(qApp);
+            timer->setInterval(LRC_FRAME_TIME);
+            m_count = 0;
+        }
+        return timer;
+    }
+
+    static int m_count;
+
+};
+
+int MusicLrcTicker::m_count = 0;
+
+
 MusicLrcColor::MusicLrcColor()
     : m_index(Color::Null)
 {
@@ -154,23 +206,25 @@ QString TTK::writeColorConfig(const QList<QColor> &colors)
 MusicLrcManager::MusicLrcManager(QWidget *parent)
     : QLabel(parent),
       m_lrcMaskWidth(0),
-      m_lrcMaskWidthInterval(0),
       m_intervalCount(0.0f),
       m_lrcPerWidth(0),
       m_transparent(100),
-      m_speedLevel(1)
+      m_speedLevel(1),
+      m_ktvMode(true),
+      m_maskDuration(0),
+      m_maskElapsed(0),
+      m_cacheHeight(0),
+      m_cacheFlags(0),
+      m_cacheShadowAlpha(0)
 {
     m_font.setBold(true);
     m_linearGradient.setStart(0, 0);
     m_maskLinearGradient.setStart(0, 0);
-
-    m_timer = new QTimer(this);
-    connect(m_timer, SIGNAL(timeout()), SLOT(updateMask()));
 }
 
 MusicLrcManager::~MusicLrcManager()
 {
-    delete m_timer;
+    detachTicker();
 }
 
 void MusicLrcManager::startDrawLrcMask(qint64 intervaltime)
@@ -178,21 +232,48 @@ void MusicLrcManager::startDrawLrcMask(qint64 intervaltime)
     m_intervalCount = 0.0f;
     m_position.setX(TTK::Widget::fontTextWidth(m_font, text()));
 
-    const float count = intervaltime / m_speedLevel;
-    m_lrcMaskWidthInterval = (count != 0) ? m_position.x() / count : 0;
+    m_maskDuration = m_speedLevel > 0 ? qint64(intervaltime * 1.0 / m_speedLevel * LRC_PER_TIME) : 0;
+    m_maskElapsed = 0;
     m_lrcMaskWidth = 0;
-    m_timer->start(LRC_PER_TIME);
+    m_ktvMode = G_SETTING_PTR->value<MusicSettingManager::OtherLrcKTVMode>();
+
+    m_maskClock.start();
+    attachTicker();
 }
 
 void MusicLrcManager::stopDrawLrc()
 {
-    m_timer->stop();
+    if(m_maskClock.isValid())
+    {
+        m_maskElapsed += m_maskClock.elapsed();
+        m_maskClock.invalidate();
+    }
+
+    detachTicker();
     update();
 }
 
 void MusicLrcManager::startDrawLrc()
 {
-    m_timer->start(LRC_PER_TIME);
+    m_maskClock.start();
+    attachTicker();
+}
+
+void MusicLrcManager::setDrawLrcPosition(qint64 elapsed)
+{
+    if(m_maskDuration <= 0 || elapsed < 0)
+    {
+        return;
+    }
+
+    //Player position is the reference, the clock only fills the gap between two position updates
+    m_maskElapsed = elapsed;
+    if(m_maskClock.isValid())
+    {
+        m_maskClock.start();
+        attachTicker();
+    }
+    updateMask();
 }
 
 void MusicLrcManager::setFontFamily(int index)
@@ -279,7 +360,11 @@ void MusicLrcManager::reset()
 {
     m_intervalCount = 0.0f;
     m_lrcMaskWidth = 0.0f;
-    m_timer->stop();
+    m_maskDuration = 0;
+    m_maskElapsed = 0;
+    m_maskClock.invalidate();
+
+    detachTicker();
     update();
 }
 
@@ -296,9 +381,26 @@ void MusicLrcManager::setLrcFontSize(int size)
 
 void MusicLrcManager::updateMask()
 {
-    //At a fixed period of time covered length increases.
-    m_lrcMaskWidth += m_lrcMaskWidthInterval;
+    const qint64 elapsed = m_maskElapsed + (m_maskClock.isValid() ? m_maskClock.elapsed() : 0);
+    if(m_maskDuration <= 0)
+    {
+        detachTicker();
+        return;
+    }
+
+    //Covered length is calculated by the elapsed play time of current line, so it never drifts.
+    const float progress = qMin(1.0f, elapsed * 1.0f / m_maskDuration);
+    m_lrcMaskWidth = progress * m_position.x();
+
+    //Scroll the long line left once the mask reaches half of the view.
+    const float overflow = qMax(0, m_position.x() - m_lrcPerWidth);
+    m_intervalCount = -qBound(0.0f, m_lrcMaskWidth - m_lrcPerWidth / 2, overflow);
     update();
+
+    if(progress >= 1.0f)
+    {
+        detachTicker();
+    }
 }
 
 void MusicLrcManager::setText(const QString &str)
@@ -306,3 +408,98 @@ void MusicLrcManager::setText(const QString &str)
     m_position.setX(TTK::Widget::fontTextWidth(m_font, str));
     QLabel::setText(str);
 }
+
+void MusicLrcManager::updateCache(const QFont &font, int height, int flags, int shadowAlpha)
+{
+    const QString &str = text();
+    if(!m_lrcPixmap.isNull() && m_cacheText == str && m_cacheFont == font && m_cacheHeight == height && m_cacheFlags == flags &&
+        m_cacheShadowAlpha == shadowAlpha && m_cacheGradient == m_linearGradient && m_cacheMaskGradient == m_maskLinearGradient)
+    {
+        return;
+    }
+
+    m_cacheText = str;
+    m_cacheFont = font;
+    m_cacheHeight = height;
+    m_cacheFlags = flags;
+    m_cacheShadowAlpha = shadowAlpha;
+    m_cacheGradient = m_linearGradient;
+    m_cacheMaskGradient = m_maskLinearGradient;
+
+    const int fontHeight = TTK::Widget::fontTextHeight(font);
+    const QSize size(qMax(1, TTK::Widget::fontTextWidth(font, str) + 1), qMax(1, height + 1));
+    const QRect rect(0, 0, size.width() - 1, size.height() - 1);
+#if TTK_QT_VERSION_CHECK(5,6,0)
+    const qreal ratio = devicePixelRatioF();
+#else
+    const qreal ratio = 1;
+#endif
+
+    QLinearGradient linearGradient(m_linearGradient), maskLinearGradient(m_maskLinearGradient);
+    linearGradient.setFinalStop(0, fontHeight);
+    maskLinearGradient.setFinalStop(0, fontHeight);
+
+    m_lrcPixmap = QPixmap(size * ratio);
+    m_lrcMaskPixmap = QPixmap(size * ratio);
+#if TTK_QT_VERSION_CHECK(5,6,0)
+    m_lrcPixmap.setDevicePixelRatio(ratio);
+    m_lrcMaskPixmap.setDevicePixelRatio(ratio);
+#endif
+    m_lrcPixmap.fill(Qt::transparent);
+    m_lrcMaskPixmap.fill(Qt::transparent);
+
+    QPainter painter(&m_lrcPixmap);
+    painter.setFont(font);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+    //Draw the underlying text, such as shadow, will make the effect more clearly, and more texture
+    painter.setPen(QColor(0, 0, 0, shadowAlpha));
+    painter.drawText(rect.translated(1, 1), flags, str);
+    //Then draw a gradient in the above
+    painter.setPen(QPen(linearGradient, 0));
+    painter.drawText(rect, flags, str);
+    painter.end();
+
+    painter.begin(&m_lrcMaskPixmap);
+    painter.setFont(font);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+    painter.setPen(QPen(maskLinearGradient, 0));
+    painter.drawText(rect, flags, str);
+    painter.end();
+}
+
+void MusicLrcManager::drawCache(QPainter *painter, int x, int y, int maskWidth) const
+{
+    painter->drawPixmap(x, y, m_lrcPixmap);
+    if(maskWidth <= 0)
+    {
+        return;
+    }
+
+#if TTK_QT_VERSION_CHECK(5,6,0)
+    const qreal ratio = m_lrcMaskPixmap.devicePixelRatio();
+#else
+    const qreal ratio = 1;
+#endif
+    //Set lyrics mask, clip the cached mask text by covered length
+    const int width = qMin(m_lrcMaskPixmap.width(), qRound(maskWidth * ratio));
+    painter->drawPixmap(QPointF(x, y), m_lrcMaskPixmap, QRectF(0, 0, width, m_lrcMaskPixmap.height()));
+}
+
+int MusicLrcManager::maskWidth() const
+{
+    if(!m_ktvMode)
+    {
+        return (m_lrcMaskWidth != 0) ? m_position.x() : m_lrcMaskWidth;
+    }
+    return m_lrcMaskWidth;
+}
+
+void MusicLrcManager::attachTicker()
+{
+    MusicLrcTicker::attach(this);
+}
+
+void MusicLrcManager::detachTicker()
+{
+    MusicLrcTicker::detach(this);
+}
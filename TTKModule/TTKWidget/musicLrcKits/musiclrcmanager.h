@@ -22,10 +22,12 @@
 #include <QTimer>
 #include <QAction>
 #include <QMouseEvent>
+#include <QElapsedTimer>
 #include "musicglobaldefine.h"
 #include "musicwidgetheaders.h"
 
 static constexpr int LRC_PER_TIME = 30;
+static constexpr int LRC_FRAME_TIME = 16;
 static constexpr int LRC_COLOR_OFFSET = 9;
 
 /*! @brief The class of the lrc color.
@@ -91,6 +93,8 @@ namespace TTK
 
 
 /*! @brief The class of the lrc manager base.
+ * Lrc text and its mask are rasterized once into cached pixmaps, the mask width
+ * follows the elapsed play time of current line and all lrc managers share one frame tick.
  * @author Greedysky <greedysky@163.com>
  */
 class TTK_MODULE_EXPORT MusicLrcManager : public QLabel
@@ -119,6 +123,10 @@ public:
      * Stop timer clock to draw lrc mask.
      */
     void stopDrawLrc();
+    /*!
+     * Sync lrc mask by elapsed play time of current line.
+     */
+    void setDrawLrcPosition(qint64 elapsed);
 
     /*!
      * Set lrc font family by given type.
@@ -184,7 +192,7 @@ public:
 
 public Q_SLOTS:
     /*!
-     * Time out to calculate lrc mask line length.
+     * Frame tick to calculate lrc mask line length.
      */
     void updateMask();
     /*!
@@ -193,14 +201,45 @@ public Q_SLOTS:
     void setText(const QString &str);
 
 protected:
+    /*!
+     * Rasterize lrc text with its shadow and mask text into cached pixmaps if changed.
+     */
+    void updateCache(const QFont &font, int height, int flags, int shadowAlpha);
+    /*!
+     * Draw cached lrc text and mask text clipped by given width.
+     */
+    void drawCache(QPainter *painter, int x, int y, int maskWidth) const;
+    /*!
+     * Get current mask width by lrc ktv mode.
+     */
+    int maskWidth() const;
+
+    /*!
+     * Attach to the shared frame tick.
+     */
+    void attachTicker();
+    /*!
+     * Detach from the shared frame tick.
+     */
+    void detachTicker();
+
     QFont m_font;
-    QTimer *m_timer;
     QLinearGradient m_linearGradient, m_maskLinearGradient;
-    float m_lrcMaskWidth, m_lrcMaskWidthInterval, m_intervalCount;
+    float m_lrcMaskWidth, m_intervalCount;
 
     int m_lrcPerWidth, m_transparent, m_speedLevel;
     QPoint m_position;
 
+    bool m_ktvMode;
+    qint64 m_maskDuration, m_maskElapsed;
+    QElapsedTimer m_maskClock;
+
+    QPixmap m_lrcPixmap, m_lrcMaskPixmap;
+    QString m_cacheText;
+    QFont m_cacheFont;
+    QLinearGradient m_cacheGradient, m_cacheMaskGradient;
+    int m_cacheHeight, m_cacheFlags, m_cacheShadowAlpha;
+
 };
 
 #endif // MUSICLRCMANAGER_H
@@ -1,5 +1,4 @@
 #include "musiclrcmanagerfordesktop.h"
-#include "musicsettingmanager.h"
 #include "musicwidgetutils.h"
 
 MusicLrcManagerForDesktop::MusicLrcManagerForDesktop(QWidget *parent)
@@ -20,37 +19,14 @@ MusicLrcManagerHorizontalDesktop::MusicLrcManagerHorizontalDesktop(QWidget *pare
 void MusicLrcManagerHorizontalDesktop::paintEvent(QPaintEvent *)
 {
     QPainter painter(this);
-    painter.setFont(m_font);
     painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
 
     const int fontHeight = TTK::Widget::fontTextHeight(m_font);
     const int begin = (rect().height() - fontHeight) / 2;
-    m_linearGradient.setFinalStop(0, fontHeight);
-    m_maskLinearGradient.setFinalStop(0, fontHeight);
 
-    if(m_position.x() + m_intervalCount >= m_lrcPerWidth && m_lrcMaskWidth >= m_lrcPerWidth / 2)
-    {
-        m_intervalCount -= m_lrcMaskWidthInterval;
-    }
-
-    //Draw the underlying text, such as shadow, will make the effect more clearly,
-    //and more texture
-    painter.setPen(QColor(0, 0, 0, 2 * m_transparent));
-    painter.drawText(m_intervalCount + 1, begin + 1, m_position.x(), m_position.y(), Qt::AlignLeft, text());
-
-    //Then draw a gradient in the above
-    painter.setPen(QPen(m_linearGradient, 0));
-    painter.drawText(m_intervalCount, begin, m_position.x(), m_position.y(), Qt::AlignLeft, text());
-
-    int offsetValue = m_lrcMaskWidth;
-    if(!G_SETTING_PTR->value(MusicSettingManager::OtherLrcKTVMode).toBool())
-    {
-        offsetValue = (m_lrcMaskWidth != 0) ? m_position.x() : m_lrcMaskWidth;
-    }
-
-    //Set lyrics mask
-    painter.setPen(QPen(m_maskLinearGradient, 0));
-    painter.drawText(m_intervalCount, begin, offsetValue, 60, Qt::AlignLeft, text());
+    //Text and shadow are rendered once per line, mask is clipped by covered length
+    updateCache(m_font, fontHeight, Qt::AlignLeft, 2 * m_transparent);
+    drawCache(&painter, m_intervalCount, begin, maskWidth());
 }
 
 
@@ -63,37 +39,15 @@ MusicLrcManagerVerticalDesktop::MusicLrcManagerVerticalDesktop(QWidget *parent)
 void MusicLrcManagerVerticalDesktop::paintEvent(QPaintEvent *)
 {
     QPainter painter(this);
-    painter.setFont(m_font);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
 
     const int fontHeight = TTK::Widget::fontTextHeight(m_font);
-    m_linearGradient.setFinalStop(0, fontHeight);
-    m_maskLinearGradient.setFinalStop(0, fontHeight);
-
-    if(m_position.x() + m_intervalCount >= m_lrcPerWidth && m_lrcMaskWidth >= m_lrcPerWidth / 2)
-    {
-        m_intervalCount -= m_lrcMaskWidthInterval;
-    }
 
     painter.translate(m_position.y(), 0);
     painter.rotate(TTK_AN_90);
 
-    //Draw the underlying text, such as shadow, will make the effect more clearly,
-    //and more texture
-    painter.setPen(QColor(0, 0, 0, 2 * m_transparent));
-    painter.drawText(m_intervalCount + 1, 1, m_position.x(), m_position.y(), Qt::AlignLeft, text());
-
-    //Then draw a gradient in the above
-    painter.setPen(QPen(m_linearGradient, 0));
-    painter.drawText(m_intervalCount, 0, m_position.x(), m_position.y(), Qt::AlignLeft, text());
-
-    int offsetValue = m_lrcMaskWidth;
-    if(!G_SETTING_PTR->value(MusicSettingManager::OtherLrcKTVMode).toBool())
-    {
-        offsetValue = (m_lrcMaskWidth != 0) ? m_position.x() : m_lrcMaskWidth;
-    }
-
-    //Set lyrics mask
-    painter.setPen(QPen(m_maskLinearGradient, 0));
-    painter.drawText(m_intervalCount, 0, offsetValue, 60, Qt::AlignLeft, text());
+    //Text and shadow are rendered once per line, mask is clipped by covered length
+    updateCache(m_font, fontHeight, Qt::AlignLeft, 2 * m_transparent);
+    drawCache(&painter, m_intervalCount, 0, maskWidth());
     painter.translate(-m_position.y(), 0);
 }
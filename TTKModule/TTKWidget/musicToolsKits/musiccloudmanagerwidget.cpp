@@ -16,6 +16,7 @@
 #include "qsync/qsyncdownloaddata.h"
 
 static constexpr const char *QUERY_CLOUD_URL = "cloud";
+static constexpr int UPLOAD_PARALLEL_COUNT = 3;
 
 Q_DECLARE_METATYPE(MusicCloudDataItem)
 
@@ -23,6 +24,7 @@ MusicCloudManagerTableWidget::MusicCloudManagerTableWidget(QWidget *parent)
     : MusicAbstractTableWidget(parent),
       m_uploading(false),
       m_cancel(false),
+      m_uploadingCount(0),
       m_totalFileSzie(0),
       m_openFileWidget(nullptr)
 {
@@ -48,10 +50,12 @@ MusicCloudManagerTableWidget::MusicCloudManagerTableWidget(QWidget *parent)
     m_syncDeleteData = new QSyncDeleteData(m_manager, this);
     m_syncUploadData = new QSyncUploadData(m_manager, this);
     m_syncDownloadData = new QSyncDownloadData(m_manager, this);
+    m_syncUploadData->setResumeFilePath(APPCACHE_DIR_FULL + "uploadresume");
 
     connect(m_syncListData, SIGNAL(receiveFinshed(QSyncDataItemList)), SLOT(receiveDataFinshed(QSyncDataItemList)));
     connect(m_syncDeleteData, SIGNAL(deleteFileFinished(bool)), SLOT(deleteFileFinished(bool)));
     connect(m_syncUploadData, SIGNAL(uploadFileFinished(QString)), SLOT(uploadFileFinished(QString)));
+    connect(m_syncUploadData, SIGNAL(uploadFileFailed(QString)), SLOT(uploadFileFailed(QString)));
 
     G_CONNECTION_PTR->setValue(className(), this);
     G_CONNECTION_PTR->connect(className(), MusicCloudUploadTableWidget::className());
@@ -162,27 +166,26 @@ void MusicCloudManagerTableWidget::receiveDataFinshed(const QSyncDataItemList &i
 
 void MusicCloudManagerTableWidget::uploadFileFinished(const QString &time)
 {
-    if(time == TTK_NAN_STR)
-    {
-        Q_EMIT uploadFileError(m_currentDataItem);
-    }
+    --m_uploadingCount;
 
-    const int row = FindUploadItemRow(time);
-    if(row != -1)
+    const MusicCloudDataItem &data = updateItemState(FindUploadItemRow(time), MusicCloudDataItem::State::Successed);
+    if(data.isValid())
     {
-        QTableWidgetItem *it = item(row, 0);
-        if(it)
-        {
-            MusicCloudDataItem data = it->data(TTK_DATA_ROLE).value<MusicCloudDataItem>();
-            data.m_state = MusicCloudDataItem::State::Successed;
-            it->setData(TTK_DATA_ROLE, QVariant::fromValue<MusicCloudDataItem>(data));
-            m_totalFileSzie += data.m_data.m_size;
-        }
+        m_totalFileSzie += data.m_data.m_size;
         Q_EMIT updataSizeLabel(m_totalFileSzie);
     }
-    else
+
+    startToUploadFile();
+}
+
+void MusicCloudManagerTableWidget::uploadFileFailed(const QString &time)
+{
+    --m_uploadingCount;
+
+    const MusicCloudDataItem &data = updateItemState(FindUploadItemRow(time), MusicCloudDataItem::State::Errored);
+    if(data.isValid())
     {
-        Q_EMIT uploadFileError(m_currentDataItem);
+        Q_EMIT uploadFileError(data);
     }
 
     startToUploadFile();
@@ -346,7 +349,6 @@ void MusicCloudManagerTableWidget::uploadProgress(const QString &time, qint64 pe
 void MusicCloudManagerTableWidget::uploadDone()
 {
     m_uploading = false;
-    m_currentDataItem.clear();
     updateListFromServer();
 }
 
@@ -376,7 +378,7 @@ void MusicCloudManagerTableWidget::contextMenuEvent(QContextMenuEvent *event)
     QMenu uploadMenu(tr("Upload"), &menu);
     menu.setStyleSheet(TTK::UI::MenuStyle02);
 
-    if(m_currentDataItem.isValid() && m_currentDataItem.m_state == MusicCloudDataItem::State::Waited)
+    if(m_uploading && !m_cancel)
     {
         uploadMenu.addAction(tr("Cancel Upload"), this, SLOT(cancelUploadFilesToServer()));
     }
@@ -498,21 +500,39 @@ void MusicCloudManagerTableWidget::startToUploadFile()
     m_uploading = true;
     Q_EMIT updateLabelMessage(tr("Files is uploading..."));
 
-    if(m_cancel)
+    while(!m_cancel && m_uploadingCount < UPLOAD_PARALLEL_COUNT)
+    {
+        const MusicCloudDataItem &data = updateItemState(FindWaitedItemRow(), MusicCloudDataItem::State::Uploaded);
+        if(!data.isValid())
+        {
+            break;
+        }
+
+        ++m_uploadingCount;
+        m_syncUploadData->request(data.m_id, SYNC_MUSIC_BUCKET, data.m_data.m_name, data.m_path);
+    }
+
+    // wait for all running uploads finished
+    if(m_uploadingCount <= 0)
     {
         m_cancel = false;
+        m_uploadingCount = 0;
         uploadDone();
-        return;
     }
+}
 
-    m_currentDataItem = FindWaitedItemRow();
-    if(!m_currentDataItem.isValid())
+MusicCloudDataItem MusicCloudManagerTableWidget::updateItemState(int row, MusicCloudDataItem::State state)
+{
+    QTableWidgetItem *it = row != -1 ? item(row, 0) : nullptr;
+    if(it == nullptr)
     {
-        uploadDone();
-        return;
+        return MusicCloudDataItem();
     }
 
-    m_syncUploadData->request(m_currentDataItem.m_id, SYNC_MUSIC_BUCKET, m_currentDataItem.m_data.m_name, m_currentDataItem.m_path);
+    MusicCloudDataItem data = it->data(TTK_DATA_ROLE).value<MusicCloudDataItem>();
+    data.m_state = state;
+    it->setData(TTK_DATA_ROLE, QVariant::fromValue<MusicCloudDataItem>(data));
+    return data;
 }
 
 int MusicCloudManagerTableWidget::FindUploadItemRow(const QString &time) const
@@ -534,7 +554,7 @@ int MusicCloudManagerTableWidget::FindUploadItemRow(const QString &time) const
     return -1;
 }
 
-MusicCloudDataItem MusicCloudManagerTableWidget::FindWaitedItemRow() const
+int MusicCloudManagerTableWidget::FindWaitedItemRow() const
 {
     for(int i = 0; i < rowCount(); ++i)
     {
@@ -547,10 +567,10 @@ MusicCloudDataItem MusicCloudManagerTableWidget::FindWaitedItemRow() const
         const MusicCloudDataItem &data = it->data(TTK_DATA_ROLE).value<MusicCloudDataItem>();
         if(data.m_state == MusicCloudDataItem::State::Waited)
         {
-            return data;
+            return i;
         }
     }
-    return MusicCloudDataItem();
+    return -1;
 }
 
 
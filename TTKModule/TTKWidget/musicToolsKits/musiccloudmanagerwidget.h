@@ -88,6 +88,10 @@ public Q_SLOTS:
      * Upload data to sync finshed.
      */
     void uploadFileFinished(const QString &time);
+    /*!
+     * Upload data to sync failed.
+     */
+    void uploadFileFailed(const QString &time);
     /*!
      * Delete data to sync finshed.
      */
@@ -162,9 +166,13 @@ private:
      */
     void createUploadFileModule();
     /*!
-     * Start to upload files to server.
+     * Start to upload waited files to server, at most UPLOAD_PARALLEL_COUNT files at the same time.
      */
     void startToUploadFile();
+    /*!
+     * Update upload item state by row.
+     */
+    MusicCloudDataItem updateItemState(int row, MusicCloudDataItem::State state);
     /*!
      * Find upload item row.
      */
@@ -172,10 +180,11 @@ private:
     /*!
      * Find waited item row.
      */
-    MusicCloudDataItem FindWaitedItemRow() const;
+    int FindWaitedItemRow() const;
 
     bool m_uploading;
     bool m_cancel;
+    int m_uploadingCount;
     qint64 m_totalFileSzie;
     QSyncListData *m_syncListData;
     QSyncDeleteData *m_syncDeleteData;
@@ -183,7 +192,6 @@ private:
     QSyncDownloadData *m_syncDownloadData;
     QNetworkAccessManager *m_manager;
     MusicOpenFileWidget *m_openFileWidget;
-    MusicCloudDataItem m_currentDataItem;
     TTKProgressBarItemDelegate *m_progressBarDelegate;
 
 };
@@ -12,6 +12,7 @@
 #include "musictoastlabel.h"
 #include "musicfileutils.h"
 #include "musicformats.h"
+#include "musicsongimportthread.h"
 
 #include <QMimeData>
 
@@ -51,6 +52,12 @@ MusicSongsContainerWidget::~MusicSongsContainerWidget()
     delete m_listFunctionWidget;
     delete m_songSearchWidget;
 
+    for(MusicSongImportThread *thread : findChildren<MusicSongImportThread*>())
+    {
+        thread->stop();
+    }
+    qDeleteAll(m_importProgress);
+
     while(!m_containerItems.isEmpty())
     {
         delete m_containerItems.takeLast().m_itemWidget;
@@ -231,7 +238,7 @@ void MusicSongsContainerWidget::importSongsByUrl(const QString &path, int playli
     }
 }
 
-void MusicSongsContainerWidget::importSongsByPath(const QStringList &files, int playlistRow)
+void MusicSongsContainerWidget::importSongsByPath(const QStringList &files, int playlistRow, bool sync)
 {
     if(files.isEmpty())
     {
@@ -245,32 +252,58 @@ void MusicSongsContainerWidget::importSongsByPath(const QStringList &files, int
 
     closeSearchWidgetInNeed();
 
-    MusicProgressWidget progress;
-    progress.setTitle(tr("Import file mode"));
-    progress.setRange(0, files.count());
-    progress.show();
-
     MusicSongItem *item = &m_containerItems[playlistRow];
 
-    int i = 0;
-    for(const QString &path : qAsConst(files))
+    QSet<QString> paths;
+    paths.reserve(item->m_songs.count() + files.count());
+    for(const MusicSong &song : qAsConst(item->m_songs))
+    {
+        paths.insert(song.path());
+    }
+
+    QStringList newFiles;
+    for(const QString &file : qAsConst(files))
     {
-        if(item->m_songs.contains(MusicSong(path)))
+        // same as the path normalized by song
+        QString path = file;
+        path.replace(TTK_WSEPARATOR, TTK_SEPARATOR);
+
+        if(!paths.contains(path))
         {
-            continue;
+            paths.insert(path);
+            newFiles << path;
         }
+    }
 
-        progress.setValue(++i);
-        item->m_songs << TTK::generateSongList(path);
+    if(newFiles.isEmpty())
+    {
+        MusicToastLabel::popup(tr("Import music songs done"));
+        return;
     }
 
-    if(i != 0)
+    if(!sync)
     {
-        item->m_itemWidget->updateSongsList(item->m_songs);
-        setItemTitle(item);
         setCurrentIndex(playlistRow);
+        startImportThread(item->m_itemIndex, newFiles);
+        return;
     }
 
+    MusicProgressWidget progress;
+    progress.setTitle(tr("Import file mode"));
+    progress.setRange(0, newFiles.count());
+    progress.show();
+
+    int i = 0;
+    for(const QString &path : qAsConst(newFiles))
+    {
+        progress.setValue(++i);
+        item->m_songs << TTK::generateSongList(path);
+    }
+
+    item->m_itemWidget->updateSongsList(item->m_songs);
+    setItemTitle(item);
+    setCurrentIndex(playlistRow);
+
     MusicToastLabel::popup(tr("Import music songs done"));
 }
 
@@ -449,6 +482,7 @@ void MusicSongsContainerWidget::deleteRowItem(int index)
 
     const MusicSongItem *item = &m_containerItems[id];
     MusicPlayedListPopWidget::instance()->remove(item->m_itemIndex, item->m_songs);
+    m_searchIndexs.remove(item->m_itemIndex);
 
     if(m_playRowIndex == id)
     {
@@ -487,6 +521,7 @@ void MusicSongsContainerWidget::deleteRowItems()
     for(int i = m_containerItems.count() - 1; i > 3; --i)
     {
         MusicSongItem item = m_containerItems.takeLast();
+        m_searchIndexs.remove(item.m_itemIndex);
         removeItem(item.m_itemWidget);
         delete item.m_itemWidget;
     }
@@ -676,14 +711,14 @@ void MusicSongsContainerWidget::searchResultChanged(int, int column)
 
     if(!isSearchedPlayIndex())
     {
-        const QStringList searchedSongs(songsFileName(m_lastSearchIndex));
+        MusicSongItem *item = &m_containerItems[m_lastSearchIndex];
+
         TTKIntList result;
-        for(int i = 0; i < searchedSongs.count(); ++i)
+        for(int i = 0; i < item->m_songs.count(); ++i)
         {
             result << i;
         }
 
-        MusicSongItem *item = &m_containerItems[m_lastSearchIndex];
         TTKObjectCast(MusicSongsListPlayTableWidget*, item->m_itemWidget)->updateSearchFileName(&item->m_songs, result);
 
         if(item->m_songs.isEmpty())
@@ -695,22 +730,14 @@ void MusicSongsContainerWidget::searchResultChanged(int, int column)
         m_lastSearchIndex = m_currentIndex;
     }
 
-    const QString &text = m_songSearchWidget->text();
-    const QStringList searchedSongs(songsFileName(m_currentIndex));
-
-    TTKIntList result;
-    for(int i = 0; i < searchedSongs.count(); ++i)
-    {
-        if(searchedSongs[i].contains(text, Qt::CaseInsensitive))
-        {
-            result << i;
-        }
-    }
+    MusicSongItem *item = &m_containerItems[m_currentIndex];
+    MusicSongSearchIndex *index = &m_searchIndexs[item->m_itemIndex];
+    index->update(item->m_songs);
 
+    const TTKIntList &result = index->search(m_songSearchWidget->text());
     m_searchResultLevel = column;
     m_searchResultItems.insert(column, result);
 
-    MusicSongItem *item = &m_containerItems[m_currentIndex];
     TTKObjectCast(MusicSongsListPlayTableWidget*, item->m_itemWidget)->updateSearchFileName(&item->m_songs, result);
 
     if(column == 0)
@@ -840,7 +867,7 @@ void MusicSongsContainerWidget::addSongToPlaylist(const QStringList &items)
 
     QStringList files(items);
     const int row = makeValidIndex();
-    importSongsByPath(files, row);
+    importSongsByPath(files, row, true);
 
     const MusicSongItem *item = &m_containerItems[row];
     const MusicSongList *musicSongs = &item->m_songs;
@@ -1046,19 +1073,7 @@ void MusicSongsContainerWidget::songListSortBy(int index)
     MusicSongList *songs = &m_containerItems[id].m_songs;
     const MusicSong song(MusicApplication::instance()->currentFilePath());
 
-    for(int i = 0; i < songs->count(); ++i)
-    {
-        (*songs)[i].setSort(sort);
-    }
-
-    if(m_containerItems[id].m_sort.m_order == Qt::DescendingOrder)
-    {
-        std::sort(songs->begin(), songs->end());
-    }
-    else
-    {
-        std::sort(songs->begin(), songs->end(), std::greater<MusicSong>());
-    }
+    TTK::sortSongList(songs, sort, m_containerItems[id].m_sort.m_order == Qt::DescendingOrder);
 
     widget->removeItems();
     widget->setSongsList(songs);
@@ -1182,17 +1197,54 @@ void MusicSongsContainerWidget::dropEvent(QDropEvent *event)
         item.m_itemName = QFileInfo(dir).baseName();
         checkTitleNameValid(item.m_itemName);
 
-        const QStringList &files = TTK::File::fileListByPath(dir, MusicFormats::supportMusicInputFilterFormats());
-        for(const QString &path : qAsConst(files))
-        {
-            item.m_songs << TTK::generateSongList(path);
-        }
-
         m_containerItems << item;
         createWidgetItem(&m_containerItems.back());
+        startImportThread(m_containerItems.back().m_itemIndex, {dir});
     }
 }
 
+void MusicSongsContainerWidget::importSongsChanged(const MusicSongList &songs)
+{
+    MusicSongImportThread *thread = TTKObjectCast(MusicSongImportThread*, sender());
+    if(!thread)
+    {
+        return;
+    }
+
+    const int id = foundMappedIndex(thread->property("itemIndex").toInt());
+    if(id == -1)
+    {
+        thread->stop();
+        return;
+    }
+
+    MusicSongItem *item = &m_containerItems[id];
+    item->m_songs << songs;
+    item->m_itemWidget->updateSongsList(item->m_songs);
+    setItemTitle(item);
+}
+
+void MusicSongsContainerWidget::importSongsProgressChanged(int value, int total)
+{
+    MusicProgressWidget *progress = m_importProgress.value(sender());
+    if(!progress)
+    {
+        return;
+    }
+
+    if(progress->maximum() != total)
+    {
+        progress->setRange(0, total);
+    }
+    progress->setValue(value);
+}
+
+void MusicSongsContainerWidget::importSongsFinished()
+{
+    delete m_importProgress.take(sender());
+    MusicToastLabel::popup(tr("Import music songs done"));
+}
+
 void MusicSongsContainerWidget::contextMenuEvent(QContextMenuEvent *event)
 {
     MusicSongsToolBoxWidget::contextMenuEvent(event);
@@ -1270,6 +1322,7 @@ void MusicSongsContainerWidget::createWidgetItem(MusicSongItem *item)
     connect(widget, SIGNAL(addSongToLovestList(bool,int)), SLOT(addSongToLovestList(bool,int)));
     connect(widget, SIGNAL(showFloatWidget()), SLOT(showFloatWidget()));
     connect(widget, SIGNAL(songListSortBy(int)), SLOT(songListSortBy(int)));
+    connect(m_scrollArea->verticalScrollBar(), SIGNAL(valueChanged(int)), widget, SLOT(updateVisibleItems()));
 
     ///connect to items
     setInputModule(m_itemList.back().m_widgetItem);
@@ -1316,6 +1369,26 @@ void MusicSongsContainerWidget::resizeWindow()
     }
 }
 
+void MusicSongsContainerWidget::startImportThread(int itemIndex, const QStringList &paths)
+{
+    MusicSongImportThread *thread = new MusicSongImportThread(this);
+    thread->setProperty("itemIndex", itemIndex);
+    thread->setImportFilePath(paths);
+    connect(thread, SIGNAL(importSongsChanged(MusicSongList)), SLOT(importSongsChanged(MusicSongList)));
+    connect(thread, SIGNAL(importProgressChanged(int,int)), SLOT(importSongsProgressChanged(int,int)));
+    connect(thread, SIGNAL(importFinished()), SLOT(importSongsFinished()));
+    connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+
+    MusicProgressWidget *progress = new MusicProgressWidget;
+    progress->setTitle(tr("Import file mode"));
+    // file count is known once discovery is done, stay busy until first progress
+    progress->setRange(0, 0);
+    progress->show();
+    m_importProgress.insert(thread, progress);
+
+    thread->start();
+}
+
 void MusicSongsContainerWidget::updatePlayedList(int begin, int end)
 {
     for(const MusicSongItem &item : qAsConst(m_containerItems))
@@ -20,9 +20,11 @@
  ***************************************************************************/
 
 #include "musicsearchinterface.h"
+#include "musicsongsearchindex.h"
 #include "musicsongstoolboxwidget.h"
 #include "musicsongsearchonlinewidget.h"
 
+class MusicProgressWidget;
 class MusicSongSearchDialog;
 class MusicSongsListWidget;
 class MusicSongsListFunctionWidget;
@@ -72,8 +74,10 @@ public:
     void importSongsByUrl(const QString &path, int playlistRow);
     /*!
      * Input imported music datas into container.
+     * Existing files are skipped, songs are read in background and appended by batches
+     * unless sync is set, which is used when the songs are played at once.
      */
-    void importSongsByPath(const QStringList &files, int playlistRow);
+    void importSongsByPath(const QStringList &files, int playlistRow, bool sync = false);
 
     /*!
      * Get music songs file name by index.
@@ -247,6 +251,18 @@ private Q_SLOTS:
      * Delete the float function widget.
      */
     void deleteFloatWidget();
+    /*!
+     * Import songs batch changed by import thread.
+     */
+    void importSongsChanged(const MusicSongList &songs);
+    /*!
+     * Import songs progress changed by import thread.
+     */
+    void importSongsProgressChanged(int value, int total);
+    /*!
+     * Import songs finished by import thread.
+     */
+    void importSongsFinished();
 
 private:
     /*!
@@ -289,6 +305,10 @@ private:
      * Resize window bound by resize called.
      */
     void resizeWindow();
+    /*!
+     * Start import thread for the given item by paths.
+     */
+    void startImportThread(int itemIndex, const QStringList &paths);
     /*!
      * Update current played list.
      */
@@ -297,6 +317,8 @@ private:
     int m_playRowIndex;
     int m_lastSearchIndex;
     int m_selectDeleteIndex;
+    QMap<int, MusicSongSearchIndex> m_searchIndexs;
+    QMap<QObject*, MusicProgressWidget*> m_importProgress;
 
     MusicSongsToolBoxMaskWidget *m_listMaskWidget;
     MusicSongsListFunctionWidget *m_listFunctionWidget;
@@ -4,16 +4,14 @@
 #include "musicwidgetheaders.h"
 #include "musicqmmputils.h"
 #include "musictoastlabel.h"
-#include "ttksemaphoreloop.h"
+#include "musicformats.h"
+#include "musicreplaygainanalyzer.h"
 
-#include <QProcess>
 #include <QPluginLoader>
 
 #include <qmmp/lightfactory.h>
 
 static constexpr int GAIN_DEFAULT = 89;
-static constexpr const char *GAIN_TRACKDB = "Recommended \"Track\" dB change:";
-static constexpr const char *GAIN_ALBUMDB = "Recommended \"Album\" dB change for all files:";
 
 MusicReplayGainTableWidget::MusicReplayGainTableWidget(QWidget *parent)
     : MusicAbstractTableWidget(parent)
@@ -33,8 +31,7 @@ MusicReplayGainTableWidget::MusicReplayGainTableWidget(QWidget *parent)
 MusicReplayGainWidget::MusicReplayGainWidget(QWidget *parent)
     : MusicAbstractMoveWidget(parent),
       m_ui(new Ui::MusicReplayGainWidget),
-      m_replayGainWidget(nullptr),
-      m_currentIndex(-1)
+      m_replayGainWidget(nullptr)
 {
     m_ui->setupUi(this);
     setFixedSize(size());
@@ -91,12 +88,12 @@ MusicReplayGainWidget::MusicReplayGainWidget(QWidget *parent)
     m_ui->progressBar->setStyleSheet(TTK::UI::ProgressBar01);
     m_ui->progressBarAll->setStyleSheet(TTK::UI::ProgressBar01);
 
-    m_process = new QProcess(this);
-    m_process->setProcessChannelMode(QProcess::MergedChannels);
+    m_analyzer = new MusicReplayGainAnalyzer(this);
 
     initialize();
 
-    connect(m_process, SIGNAL(readyReadStandardOutput()), SLOT(analysisOutput()));
+    connect(m_analyzer, SIGNAL(analysisProgressChanged(int,int)), SLOT(analysisProgressChanged(int,int)));
+    connect(m_analyzer, SIGNAL(analysisFinished()), SLOT(analysisFinished()));
     connect(m_ui->addFileButton, SIGNAL(clicked()), SLOT(addFileButtonClicked()));
     connect(m_ui->addFilesButton, SIGNAL(clicked()), SLOT(addFilesButtonClicked()));
     connect(m_ui->rmFileButton, SIGNAL(clicked()), SLOT(rmFileButtonClicked()));
@@ -110,7 +107,9 @@ MusicReplayGainWidget::MusicReplayGainWidget(QWidget *parent)
 MusicReplayGainWidget::~MusicReplayGainWidget()
 {
     TTKRemoveSingleWidget(className());
-    delete m_process;
+    m_analyzer->disconnect(this);
+    m_analyzer->stop();
+    delete m_analyzer;
     delete m_ui;
 }
 
@@ -135,40 +134,60 @@ void MusicReplayGainWidget::initialize()
     }
 }
 
-void MusicReplayGainWidget::addItemFinished(const QString &track, const QString &album)
+void MusicReplayGainWidget::addItemsStart(const QStringList &files)
 {
-    if(m_currentIndex >= m_paths.count())
+    m_pendings.clear();
+    for(const QString &path : qAsConst(files))
+    {
+        if(!m_paths.contains(path) && !m_pendings.contains(path))
+        {
+            m_pendings << path;
+        }
+    }
+
+    if(m_pendings.isEmpty())
     {
         return;
     }
 
+    setControlEnabled(false);
+    m_ui->progressBar->setValue(0);
+    m_ui->progressBarAll->setRange(0, m_pendings.count());
+    m_ui->progressBarAll->setValue(0);
+
+    m_analyzer->setInputFiles(m_pendings);
+    m_analyzer->start();
+}
+
+void MusicReplayGainWidget::addItemFinished(const QString &path, double track, double album)
+{
     const int row = m_ui->tableWidget->rowCount();
     m_ui->tableWidget->setRowCount(row + 1);
     QHeaderView *headerView = m_ui->tableWidget->horizontalHeader();
 
     QTableWidgetItem *item = new QTableWidgetItem;
-    item->setToolTip(m_paths[m_currentIndex]);
+    item->setToolTip(path);
     item->setText(TTK::Widget::elidedText(font(), item->toolTip(), Qt::ElideRight, headerView->sectionSize(0) - 15));
     QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
     m_ui->tableWidget->setItem(row, 0, item);
 
                       item = new QTableWidgetItem;
-    item->setText(QString::number(GAIN_DEFAULT - track.toDouble()));
+    item->setText(QString::number(GAIN_DEFAULT - track));
     QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
     m_ui->tableWidget->setItem(row, 1, item);
 
                       item = new QTableWidgetItem;
-    item->setText(QString::number(m_ui->volumeLineEdit->text().toDouble() - GAIN_DEFAULT + track.toDouble()));
+    item->setText(QString::number(m_ui->volumeLineEdit->text().toDouble() - GAIN_DEFAULT + track));
     QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
     m_ui->tableWidget->setItem(row, 2, item);
 
                       item = new QTableWidgetItem;
-    item->setText(QString::number(GAIN_DEFAULT - album.toDouble()));
+    item->setText(QString::number(GAIN_DEFAULT - album));
     QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
     m_ui->tableWidget->setItem(row, 3, item);
 
                       item = new QTableWidgetItem;
-    item->setText(QString::number(m_ui->volumeLineEdit->text().toDouble() - GAIN_DEFAULT + album.toDouble()));
+    item->setText(QString::number(m_ui->volumeLineEdit->text().toDouble() - GAIN_DEFAULT + album));
     QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
     m_ui->tableWidget->setItem(row, 4, item);
 }
@@ -185,30 +204,10 @@ void MusicReplayGainWidget::setControlEnabled(bool enabled)
 
 void MusicReplayGainWidget::addFileButtonClicked()
 {
-    const QStringList &files = TTK::File::getOpenFileNames(this, "MP3 File(*.mp3)");
+    const QStringList &files = TTK::File::getOpenFileNames(this, MusicFormats::supportMusicInputFormats());
     if(!files.isEmpty())
     {
-        setControlEnabled(false);
-        const int orcount = m_paths.count();
-
-        for(const QString &path : qAsConst(files))
-        {
-            if(!m_paths.contains(path))
-            {
-                m_paths << path;
-            }
-        }
-
-        for(int i = orcount; i < m_paths.count(); ++i)
-        {
-            m_currentIndex = i;
-            TTKSemaphoreLoop loop;
-            connect(m_process, SIGNAL(finished(int)), &loop, SLOT(quit()));
-            QtProcessVoidConnect(m_process, &loop, quit, TTK_SLOT);
-            m_process->start(MAKE_GAIN_PATH_FULL, {m_paths[i]});
-            loop.exec();
-        }
-        setControlEnabled(true);
+        addItemsStart(files);
     }
 }
 
@@ -217,22 +216,7 @@ void MusicReplayGainWidget::addFilesButtonClicked()
     const QString &path = TTK::File::getExistingDirectory(this);
     if(!path.isEmpty())
     {
-        setControlEnabled(false);
-        for(const QFileInfo &fin : TTK::File::fileInfoListByPath(path))
-        {
-            if(TTK_FILE_SUFFIX(fin) == MP3_FILE_SUFFIX && !m_paths.contains(fin.absoluteFilePath()))
-            {
-                m_currentIndex = m_paths.count();
-                m_paths << fin.absoluteFilePath();
-
-                TTKSemaphoreLoop loop;
-                connect(m_process, SIGNAL(finished(int)), &loop, SLOT(quit()));
-                QtProcessVoidConnect(m_process, &loop, quit, TTK_SLOT);
-                m_process->start(MAKE_GAIN_PATH_FULL, {m_paths.back()});
-                loop.exec();
-            }
-        }
-        setControlEnabled(true);
+        addItemsStart(TTK::File::fileListByPath(path, MusicFormats::supportMusicInputFilterFormats()));
     }
 }
 
@@ -244,14 +228,20 @@ void MusicReplayGainWidget::rmFileButtonClicked()
         MusicToastLabel::popup(tr("Please select one item first"));
         return;
     }
+
+    if(row < m_paths.count())
+    {
+        m_analyzer->remove(m_paths.takeAt(row));
+    }
     m_ui->tableWidget->removeRow(row);
+    analysisFinished();
 }
 
 void MusicReplayGainWidget::rmFilesButtonClicked()
 {
     m_paths.clear();
+    m_analyzer->clear();
     m_ui->tableWidget->removeItems();
-    m_currentIndex = -1;
 }
 
 void MusicReplayGainWidget::analysisButtonClicked()
@@ -267,28 +257,27 @@ void MusicReplayGainWidget::applyButtonClicked()
         return;
     }
 
-    disconnect(m_process, SIGNAL(readyReadStandardOutput()), this, SLOT(analysisOutput()));
-    connect(m_process, SIGNAL(readyReadStandardOutput()), SLOT(applyOutput()));
-
     setControlEnabled(false);
     m_ui->progressBarAll->setRange(0, m_ui->tableWidget->rowCount());
 
-    for(int i = 0; i < m_ui->tableWidget->rowCount(); ++i)
+    for(int i = 0; i < m_ui->tableWidget->rowCount() && i < m_paths.count(); ++i)
     {
-        TTKSemaphoreLoop loop;
-        connect(m_process, SIGNAL(finished(int)), &loop, SLOT(quit()));
-        QtProcessVoidConnect(m_process, &loop, quit, TTK_SLOT);
-        m_process->start(MAKE_GAIN_PATH_FULL, {"-g", m_ui->tableWidget->item(i, 2)->text(), m_paths[i]});
+        MusicReplayGainItem item = m_analyzer->item(m_paths[i]);
+        if(item.isValid())
+        {
+            item.m_trackGain = m_ui->tableWidget->item(i, 2)->text().toDouble();
+            item.m_albumGain = m_ui->tableWidget->item(i, 4)->text().toDouble();
+            G_REPLAYGAIN_INDEX_PTR->insert(item);
+        }
         m_ui->progressBarAll->setValue(i + 1);
-        loop.exec();
     }
 
+    G_REPLAYGAIN_INDEX_PTR->save();
+    m_ui->progressBar->setValue(100);
+
     setControlEnabled(true);
     rmFilesButtonClicked();
 
-    disconnect(m_process, SIGNAL(readyReadStandardOutput()), this, SLOT(applyOutput()));
-    connect(m_process, SIGNAL(readyReadStandardOutput()), SLOT(analysisOutput()));
-
     MusicToastLabel::popup(tr("Music gain finished"));
 }
 
@@ -304,51 +293,35 @@ void MusicReplayGainWidget::lineTextChanged(const QString &text)
     }
 }
 
-void MusicReplayGainWidget::analysisOutput()
+void MusicReplayGainWidget::analysisProgressChanged(int value, int total)
 {
-    QString track, album;
-    while(m_process->canReadLine())
-    {
-        QByteArray data = m_process->readLine();
-        if(data.contains(GAIN_TRACKDB))
-        {
-            data.replace(GAIN_TRACKDB, {});
-            data.replace(TTK_WLINEFEED, {});
-            track = QString(data.trimmed());
-        }
+    m_ui->progressBar->setValue(total > 0 ? value * 100 / total : 100);
+    m_ui->progressBarAll->setValue(value);
+}
 
-        if(data.contains(GAIN_ALBUMDB))
+void MusicReplayGainWidget::analysisFinished()
+{
+    for(const QString &path : qAsConst(m_pendings))
+    {
+        const MusicReplayGainItem &item = m_analyzer->item(path);
+        if(item.isValid())
         {
-            data.replace(GAIN_ALBUMDB, {});
-            data.replace(TTK_WLINEFEED, {});
-            album = QString(data.trimmed());
+            m_paths << path;
+            addItemFinished(path, item.m_trackGain, item.m_albumGain);
         }
     }
+    m_pendings.clear();
 
-    if(!track.isEmpty() || !album.isEmpty())
+    // new files may join the album of existing rows, refresh their album gain
+    const double volume = m_ui->volumeLineEdit->text().toDouble();
+    for(int i = 0; i < m_ui->tableWidget->rowCount() && i < m_paths.count(); ++i)
     {
-        addItemFinished(track, album);
+        const MusicReplayGainItem &item = m_analyzer->item(m_paths[i]);
+        m_ui->tableWidget->item(i, 3)->setText(QString::number(GAIN_DEFAULT - item.m_albumGain));
+        m_ui->tableWidget->item(i, 4)->setText(QString::number(volume - GAIN_DEFAULT + item.m_albumGain));
     }
-}
 
-void MusicReplayGainWidget::applyOutput()
-{
-    while(m_process->canReadLine())
-    {
-        const QByteArray &data = m_process->readLine();
-        if(data.contains("Applying gain change"))
-        {
-            m_ui->progressBar->setValue(40);
-        }
-        else if(data.contains("done"))
-        {
-            m_ui->progressBar->setValue(100);
-        }
-        else
-        {
-            m_ui->progressBar->setValue(80);
-        }
-    }
+    setControlEnabled(true);
 }
 
 void MusicReplayGainWidget::confirmDataChanged()
@@ -365,11 +338,5 @@ void MusicReplayGainWidget::confirmDataChanged()
 
 void MusicReplayGainWidget::show()
 {
-    if(!QFile::exists(MAKE_GAIN_PATH_FULL))
-    {
-        MusicToastLabel::popup(tr("Lack of plugin file"));
-        return;
-    }
-
     MusicAbstractMoveWidget::show();
 }
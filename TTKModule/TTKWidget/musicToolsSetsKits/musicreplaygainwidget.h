@@ -42,7 +42,7 @@ namespace Ui {
 class MusicReplayGainWidget;
 }
 class Light;
-class QProcess;
+class MusicReplayGainAnalyzer;
 
 /*! @brief The class of the replay gain widget.
  * @author Greedysky <greedysky@163.com>
@@ -97,13 +97,13 @@ private Q_SLOTS:
      */
     void lineTextChanged(const QString &text);
     /*!
-     * Analysis output by process.
+     * Analysis progress changed.
      */
-    void analysisOutput();
+    void analysisProgressChanged(int value, int total);
     /*!
-     * Apply output by process.
+     * Analysis finished.
      */
-    void applyOutput();
+    void analysisFinished();
     /*!
      * Confirm Data changed.
      */
@@ -114,20 +114,23 @@ private:
      * Init parameters.
      */
     void initialize();
+    /*!
+     * Start analysis input files.
+     */
+    void addItemsStart(const QStringList &files);
     /*!
      * Create table item finished.
      */
-    void addItemFinished(const QString &track, const QString &album);
+    void addItemFinished(const QString &path, double track, double album);
     /*!
      * Enable or disable control state.
      */
     void setControlEnabled(bool enabled);
 
     Ui::MusicReplayGainWidget *m_ui;
-    QProcess *m_process;
-    QStringList m_paths;
+    MusicReplayGainAnalyzer *m_analyzer;
+    QStringList m_paths, m_pendings;
     Light *m_replayGainWidget;
-    int m_currentIndex;
 
 };
 
@@ -119,8 +119,9 @@ void MusicSongCheckToolsDuplicateTableWidget::addCellItems(const MusicSongCheckT
         setItem(i, 0, item);
 
                           item = new QTableWidgetItem;
+        // songs are ordered by duplicate group, show the group number before the name
         item->setToolTip(v.m_song.name());
-        item->setText(TTK::Widget::elidedText(font(), item->toolTip(), Qt::ElideRight, headerView->sectionSize(1) - 45));
+        item->setText(TTK::Widget::elidedText(font(), QString("[%1] %2").arg(v.m_group + 1).arg(v.m_song.name()), Qt::ElideRight, headerView->sectionSize(1) - 45));
         QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
         setItem(i, 1, item);
 
@@ -292,6 +292,7 @@ void MusicSongCheckToolsWidget::initDuplicateWidget()
     m_ui->duplicateReCheckButton->hide();
 
     m_duplicateThread = new MusicSongCheckToolsDuplicateThread(this);
+    m_duplicateThread->setFingerprintEnabled(true);
     connect(m_duplicateThread, SIGNAL(finished(MusicSongCheckToolsDuplicateList)), SLOT(duplicateCheckFinished(MusicSongCheckToolsDuplicateList)));
 }
 
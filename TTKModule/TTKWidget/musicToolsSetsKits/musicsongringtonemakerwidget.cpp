@@ -5,10 +5,9 @@
 #include "musictoastlabel.h"
 #include "musicsongmeta.h"
 #include "musicfileutils.h"
+#include "musictranscodescheduler.h"
 #include "ttktime.h"
 
-#include <QProcess>
-
 MusicSongRingtoneMaker::MusicSongRingtoneMaker(QWidget *parent)
     : MusicAbstractMoveDialog(parent),
       m_ui(new Ui::MusicSongRingtoneMaker),
@@ -42,6 +41,7 @@ MusicSongRingtoneMaker::MusicSongRingtoneMaker(QWidget *parent)
     m_ui->saveSongButton->setFocusPolicy(Qt::NoFocus);
 #endif
     m_player = new MusicCoreMPlayer(this);
+    m_scheduler = new MusicTranscodeScheduler(this);
 
     initialize();
 
@@ -58,10 +58,13 @@ MusicSongRingtoneMaker::MusicSongRingtoneMaker(QWidget *parent)
     connect(m_ui->cutSliderWidget, SIGNAL(buttonReleaseChanged(qint64)), SLOT(buttonReleaseChanged(qint64)));
     connect(m_player, SIGNAL(positionChanged(qint64)), SLOT(positionChanged(qint64)));
     connect(m_player, SIGNAL(durationChanged(qint64)), SLOT(durationChanged(qint64)));
+    connect(m_scheduler, SIGNAL(jobFinished(int,bool)), SLOT(saveFinished(int,bool)));
 }
 
 MusicSongRingtoneMaker::~MusicSongRingtoneMaker()
 {
+    m_scheduler->disconnect(this);
+    delete m_scheduler;
     delete m_player;
     delete m_ui;
 }
@@ -117,12 +120,22 @@ void MusicSongRingtoneMaker::initOutputPath()
         return;
     }
 
-    QProcess::execute(MAKE_TRANSFORM_PATH_FULL, {
+    // run on the transcode scheduler, so that the ui is not blocked by the plugin process
+    m_ui->saveSongButton->setEnabled(false);
+    m_scheduler->addJob(m_inputFilePath, {
         "-i", m_inputFilePath, "-ss", QString::number(m_startPos),
         "-t", QString::number(m_stopPos), "-acodec", "copy",
         "-ab", m_ui->kbpsCombo->currentText() + "k",
         "-ar", m_ui->hzCombo->currentText(),
         "-ac", QString::number(m_ui->msCombo->currentIndex() + 1), value});
+    m_scheduler->start();
+}
+
+void MusicSongRingtoneMaker::saveFinished(int id, bool state)
+{
+    Q_UNUSED(id);
+    m_ui->saveSongButton->setEnabled(true);
+    MusicToastLabel::popup(state ? tr("Save ringtone finished") : tr("Save ringtone failed"));
 }
 
 void MusicSongRingtoneMaker::playInputSong()
@@ -26,6 +26,7 @@ class MusicSongRingtoneMaker;
 }
 
 class MusicCoreMPlayer;
+class MusicTranscodeScheduler;
 
 /*! @brief The class of the song ringtone maker widget.
  * @author Greedysky <greedysky@163.com>
@@ -77,6 +78,10 @@ public Q_SLOTS:
      * Moving button pos release changed.
      */
     void buttonReleaseChanged(qint64 pos);
+    /*!
+     * Save ringtone job finished.
+     */
+    void saveFinished(int id, bool state);
     /*!
      * Override exec function.
      */
@@ -96,6 +101,7 @@ private:
     bool m_playRingtone;
     QString m_inputFilePath;
     MusicCoreMPlayer *m_player;
+    MusicTranscodeScheduler *m_scheduler;
     qint64 m_startPos, m_stopPos;
 
 };
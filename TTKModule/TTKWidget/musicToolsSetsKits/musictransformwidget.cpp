@@ -4,9 +4,10 @@
 #include "musiclrcfromkrc.h"
 #include "musictoastlabel.h"
 #include "musicfileutils.h"
+#include "musictranscodescheduler.h"
 
+#include <QSet>
 #include <QSound>
-#include <QProcess>
 
 static constexpr int LINE_WIDTH = 420;
 
@@ -19,7 +20,7 @@ MusicTransformWidget::MusicTransformWidget(QWidget *parent)
     setFixedSize(size());
     setBackgroundLabel(m_ui->background);
     
-    m_process = new QProcess(this);
+    m_scheduler = new MusicTranscodeScheduler(this);
     m_ui->topTitleCloseButton->setIcon(QIcon(":/functions/btn_close_hover"));
     m_ui->topTitleCloseButton->setStyleSheet(TTK::UI::ToolButtonStyle04);
     m_ui->topTitleCloseButton->setCursor(QCursor(Qt::PointingHandCursor));
@@ -60,15 +61,18 @@ MusicTransformWidget::MusicTransformWidget(QWidget *parent)
     connect(m_ui->inputButton, SIGNAL(clicked()), SLOT(initInputPath()));
     connect(m_ui->outputButton, SIGNAL(clicked()), SLOT(initOutputPath()));
     connect(m_ui->transformButton, SIGNAL(clicked()), SLOT(startTransform()));
-    connect(m_process, SIGNAL(finished(int)), SLOT(transformFinish()));
+    connect(m_scheduler, SIGNAL(jobProgressChanged(int,int)), SLOT(jobProgressChanged(int,int)));
+    connect(m_scheduler, SIGNAL(jobFinished(int,bool)), SLOT(jobFinished(int,bool)));
+    connect(m_scheduler, SIGNAL(finished()), SLOT(transformFinish()));
     connect(m_ui->folderBox, SIGNAL(clicked(bool)), SLOT(folderBoxChecked()));
     connect(m_ui->tabButton, SIGNAL(clicked(int)), SLOT(buttonClicked(int)));
 }
 
 MusicTransformWidget::~MusicTransformWidget()
 {
-    m_process->kill();
-    delete m_process;
+    m_scheduler->disconnect(this);
+    m_scheduler->cancel();
+    delete m_scheduler;
     delete m_ui;
 }
 
@@ -131,7 +135,7 @@ void MusicTransformWidget::initOutputPath()
 
 void MusicTransformWidget::startTransform()
 {
-    if(!processTransform())
+    if(m_scheduler->isRunning())
     {
         return;
     }
@@ -139,33 +143,52 @@ void MusicTransformWidget::startTransform()
     m_ui->loadingLabel->show();
     m_ui->loadingLabel->start();
     setCheckedControl(false);
+
+    if(!processTransform())
+    {
+        setCheckedControl(true);
+        m_ui->loadingLabel->run(false);
+    }
 }
 
 void MusicTransformWidget::transformFinish()
 {
     QSound::play(":/data/sound");
 
-    m_path.removeFirst();
+    m_jobs.clear();
     m_ui->listWidget->clear();
 
-    if(!m_path.isEmpty())
+    // only failed files are left in the list
+    for(const QString &path : qAsConst(m_path))
     {
-        for(const QString &path : qAsConst(m_path))
-        {
-            m_ui->listWidget->addItem(TTK::Widget::elidedText(font(), path, Qt::ElideLeft, LINE_WIDTH));
-            m_ui->listWidget->setToolTip(path);
-        }
+        m_ui->listWidget->addItem(TTK::Widget::elidedText(font(), path, Qt::ElideLeft, LINE_WIDTH));
+        m_ui->listWidget->setToolTip(path);
+    }
 
-        if(processTransform())
-        {
-            return;
-        }
+    if(!m_path.isEmpty())
+    {
+        MusicToastLabel::popup(tr("%1 files transform failed").arg(m_path.count()));
     }
 
     setCheckedControl(true);
     m_ui->loadingLabel->run(false);
 }
 
+void MusicTransformWidget::jobProgressChanged(int id, int percent)
+{
+    updateListItem(m_jobs.value(id), QString("%1%").arg(percent));
+}
+
+void MusicTransformWidget::jobFinished(int id, bool state)
+{
+    const QString &path = m_jobs.value(id);
+    if(state)
+    {
+        m_path.removeOne(path);
+    }
+    updateListItem(path, state ? tr("Done") : tr("Failed"));
+}
+
 void MusicTransformWidget::folderBoxChecked()
 {
     m_ui->inputLineEdit->clear();
@@ -205,9 +228,27 @@ int MusicTransformWidget::exec()
     return MusicAbstractMoveDialog::exec();
 }
 
-QString MusicTransformWidget::transformSongName() const
+QString MusicTransformWidget::transformSongName(const QString &path) const
 {
-    return m_path.isEmpty() ? QString() : QFileInfo(m_path.front()).completeBaseName();
+    return QFileInfo(path).completeBaseName();
+}
+
+void MusicTransformWidget::updateListItem(const QString &path, const QString &state)
+{
+    if(path.isEmpty())
+    {
+        return;
+    }
+
+    for(int i = 0; i < m_ui->listWidget->count(); ++i)
+    {
+        QListWidgetItem *it = m_ui->listWidget->item(i);
+        if(it->data(TTK_DATA_ROLE).toString() == path)
+        {
+            it->setText(QString("[%1] %2").arg(state, TTK::Widget::elidedText(font(), path, Qt::ElideLeft, LINE_WIDTH - 50)));
+            break;
+        }
+    }
 }
 
 void MusicTransformWidget::initialize()
@@ -232,10 +273,8 @@ bool MusicTransformWidget::processTransform()
         return false;
     }
 
-    const QString &in = m_path.front().trimmed();
     const QString &out = m_ui->outputLineEdit->text().trimmed();
-
-    if(in.isEmpty() || out.isEmpty())
+    if(out.isEmpty())
     {
         MusicToastLabel::popup(tr("The output file path is empty"));
         return false;
@@ -251,16 +290,47 @@ bool MusicTransformWidget::processTransform()
         TTK_INFO_STREAM(QString("%1 %2 %3 %4").arg(m_ui->formatCombo->currentText(), m_ui->kbpsCombo->currentText(), m_ui->hzCombo->currentText())
                                               .arg(m_ui->msCombo->currentIndex() + 1));
 
-        m_process->start(MAKE_TRANSFORM_PATH_FULL, {"-i", in, "-y",
+        QSet<QString> outputs;
+        for(int i = 0; i < m_path.count(); ++i)
+        {
+            const QString &path = m_path[i];
+            const QString &in = path.trimmed();
+
+            // jobs run concurrently, inputs with the same base name must not write the same output
+            QString name = transformSongName(in);
+            for(int index = 1; outputs.contains(name.toLower()); ++index)
+            {
+                name = QString("%1(%2)").arg(transformSongName(in)).arg(index);
+            }
+            outputs.insert(name.toLower());
+
+            const int id = m_scheduler->addJob(in, {"-i", in, "-y",
                                                     "-ab", m_ui->kbpsCombo->currentText() + "k",
                                                     "-ar", m_ui->hzCombo->currentText(),
                                                     "-ac", QString::number(m_ui->msCombo->currentIndex() + 1),
-                                                    QString("%1%2-new.%3").arg(out, transformSongName(), m_ui->formatCombo->currentText().toLower())});
+                                                    QString("%1%2-new.%3").arg(out, name, m_ui->formatCombo->currentText().toLower())});
+            m_jobs.insert(id, path);
+
+            QListWidgetItem *it = m_ui->listWidget->item(i);
+            if(it)
+            {
+                it->setData(TTK_DATA_ROLE, path);
+            }
+            updateListItem(path, tr("Waiting"));
+        }
+
+        m_scheduler->start();
     }
     else
     {
-        MusicLrcFromKrc krc;
-        TTK_INFO_STREAM("Krc to lrc state: " << krc.decode(in, QString("%1%2.%3").arg(out, transformSongName(), LRC_FILE_SUFFIX)));
+        for(const QString &path : qAsConst(m_path))
+        {
+            const QString &in = path.trimmed();
+            MusicLrcFromKrc krc;
+            TTK_INFO_STREAM("Krc to lrc state: " << krc.decode(in, QString("%1%2.%3").arg(out, transformSongName(in), LRC_FILE_SUFFIX)));
+        }
+
+        m_path.clear();
         transformFinish();
     }
     return true;
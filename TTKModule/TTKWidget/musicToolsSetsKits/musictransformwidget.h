@@ -21,7 +21,7 @@
 
 #include "musicabstractmovedialog.h"
 
-class QProcess;
+class MusicTranscodeScheduler;
 
 namespace Ui {
 class MusicTransformWidget;
@@ -67,6 +67,14 @@ public Q_SLOTS:
      * Transform finished.
      */
     void transformFinish();
+    /*!
+     * Transform job progress changed.
+     */
+    void jobProgressChanged(int id, int percent);
+    /*!
+     * Transform job finished.
+     */
+    void jobFinished(int id, bool state);
     /*!
      * Input is dir not file.
      */
@@ -84,13 +92,17 @@ private:
     /*!
      * Get transform song name.
      */
-    QString transformSongName() const;
+    QString transformSongName(const QString &path) const;
+    /*!
+     * Update transform list item text by path.
+     */
+    void updateListItem(const QString &path, const QString &state);
     /*!
      * Init control parameter.
      */
     void initialize();
     /*!
-     * Start a process to transform.
+     * Queue all input files to transform.
      */
     bool processTransform();
     /*!
@@ -99,8 +111,9 @@ private:
     void setCheckedControl(bool enabled);
 
     Ui::MusicTransformWidget *m_ui;
-    QProcess *m_process;
     QStringList m_path;
+    QMap<int, QString> m_jobs;
+    MusicTranscodeScheduler *m_scheduler;
     Module m_currentType;
 
 };
@@ -99,18 +99,14 @@ void MusicPlayedListPopWidget::remove(int index)
 
 void MusicPlayedListPopWidget::remove(int playlistRow, const QString &path)
 {
-    int index = -1;
     m_tableWidget->adjustPlayWidgetRow();
 
-    do
+    const TTKIntList &index = m_playlist->remove(playlistRow, QStringList(path));
+    for(const int i : qAsConst(index))
     {
-        index = m_playlist->remove(playlistRow, path);
-        if(index != -1)
-        {
-            m_songList.removeAt(index);
-            m_tableWidget->removeRow(index);
-        }
-    } while(index != -1);
+        m_songList.removeAt(i);
+        m_tableWidget->removeRow(i);
+    }
 
     m_tableWidget->setPlayRowIndex(TTK_NORMAL_LEVEL);
     setPlaylistSongs();
@@ -123,20 +119,19 @@ void MusicPlayedListPopWidget::remove(int playlistRow, const MusicSong &song)
 
 void MusicPlayedListPopWidget::remove(int playlistRow, const MusicSongList &songs)
 {
-    int index = -1;
     m_tableWidget->adjustPlayWidgetRow();
 
+    QStringList path;
     for(const MusicSong &song : qAsConst(songs))
     {
-        do
-        {
-            index = m_playlist->remove(playlistRow, song.path());
-            if(index != -1)
-            {
-                m_songList.removeAt(index);
-                m_tableWidget->removeRow(index);
-            }
-        } while(index != -1);
+        path << song.path();
+    }
+
+    const TTKIntList &index = m_playlist->remove(playlistRow, path);
+    for(const int i : qAsConst(index))
+    {
+        m_songList.removeAt(i);
+        m_tableWidget->removeRow(i);
     }
 
     m_tableWidget->setPlayRowIndex(TTK_NORMAL_LEVEL);
@@ -10,15 +10,19 @@
 #include "musicopenfilewidget.h"
 #include "musicplayedlistpopwidget.h"
 #include "musicapplication.h"
+#include "musicsongattributethread.h"
 
 #include <qmath.h>
 #include <QAction>
 
+static constexpr int VISIBLE_ROW_PADDING = 10;
+
 MusicSongsListPlayTableWidget::MusicSongsListPlayTableWidget(int index, QWidget *parent)
     : MusicAbstractSongsListTableWidget(index, parent),
       m_parent(parent),
       m_dragStartIndex(-1),
       m_mouseMoved(false),
+      m_attributeThread(new MusicSongAttributeThread(this)),
       m_openFileWidget(nullptr),
       m_songsInfoWidget(nullptr),
       m_songsPlayWidget(nullptr),
@@ -43,13 +47,19 @@ MusicSongsListPlayTableWidget::MusicSongsListPlayTableWidget(int index, QWidget
 
     TTK::Widget::setTransparent(this, 0);
 
+    m_timerAttribute.setInterval(100);
+    m_timerAttribute.setSingleShot(true);
+
     connect(&m_timerShow, SIGNAL(timeout()), SLOT(showTimeOut()));
     connect(&m_timerStay, SIGNAL(timeout()), SLOT(stayTimeOut()));
+    connect(&m_timerAttribute, SIGNAL(timeout()), SLOT(attributeTimeOut()));
+    connect(m_attributeThread, SIGNAL(attributesChanged(QString,qint64,qint64)), SLOT(attributesChanged(QString,qint64,qint64)));
     connect(this, SIGNAL(cellDoubleClicked(int,int)), MusicApplication::instance(), SLOT(playIndexClicked(int,int)));
 }
 
 MusicSongsListPlayTableWidget::~MusicSongsListPlayTableWidget()
 {
+    m_attributeThread->stop();
     removeItems();
     delete m_openFileWidget;
     delete m_songsInfoWidget;
@@ -64,39 +74,10 @@ void MusicSongsListPlayTableWidget::updateSongsList(const MusicSongList &songs)
         return;
     }
 
-    const int count = rowCount();
+    // rows are empty here, items are created only when they become visible
     setRowCount(songs.count());
-    QHeaderView *headerView = horizontalHeader();
-
-    for(int i = count; i < songs.count(); ++i)
-    {
-        const MusicSong &v = songs[i];
-
-        QTableWidgetItem *item = new QTableWidgetItem;
-        setItem(i, 0, item);
-
-                          item = new QTableWidgetItem;
-        item->setText(TTK::Widget::elidedText(font(), v.name(), Qt::ElideRight, headerView->sectionSize(1) - 10));
-        item->setForeground(QColor(TTK::UI::Color01));
-        QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
-        setItem(i, 1, item);
-
-                          item = new QTableWidgetItem;
-        setItem(i, 2, item);
-
-                          item = new QTableWidgetItem;
-        setItem(i, 3, item);
-
-                          item = new QTableWidgetItem;
-        setItem(i, 4, item);
-
-                          item = new QTableWidgetItem(v.duration());
-        item->setForeground(QColor(TTK::UI::Color01));
-        QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
-        setItem(i, 5, item);
-    }
-
     setFixedHeight(totalHeight());
+    updateVisibleItems();
 }
 
 void MusicSongsListPlayTableWidget::selectRow(int index)
@@ -196,11 +177,10 @@ void MusicSongsListPlayTableWidget::adjustPlayWidgetRow()
     delete takeItem(m_playRowIndex, 0);
     clearSpans();
 
-    QHeaderView *headerView = horizontalHeader();
     QTableWidgetItem *item = new QTableWidgetItem;
     setItem(m_playRowIndex, 0, item);
 
-    item = new QTableWidgetItem(TTK::Widget::elidedText(font(), name, Qt::ElideRight, headerView->sectionSize(1) - 10));
+    item = new QTableWidgetItem(name);
     item->setForeground(QColor(TTK::UI::Color01));
     QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
 
@@ -455,6 +435,8 @@ void MusicSongsListPlayTableWidget::removeItemAt()
     }
 
     setFixedHeight(totalHeight());
+    //rows never created before may shift into the view after removal
+    updateVisibleItems();
     Q_EMIT deleteItemAt(deletedList, m_deleteItemWithFile);
 }
 
@@ -485,6 +467,7 @@ void MusicSongsListPlayTableWidget::setChangSongName()
     setItemDelegateForRow(currentRow(), m_renameEditDelegate);
 
     m_renameActived = true;
+    createItems(currentRow());
     m_renameItem = item(currentRow(), 1);
     m_renameItem->setText((*m_songs)[m_renameItem->row()].name());
     openPersistentEditor(m_renameItem);
@@ -603,6 +586,68 @@ void MusicSongsListPlayTableWidget::stayTimeOut()
     m_songsInfoWidget = nullptr;
 }
 
+void MusicSongsListPlayTableWidget::updateVisibleItems()
+{
+    int first = 0, last = 0;
+    if(visibleRowRange(first, last))
+    {
+        // create a little more rows ahead, so that smooth scrolling does not show empty rows
+        const int count = qMin(rowCount(), m_songs->count());
+        first = qMax(0, first - VISIBLE_ROW_PADDING);
+        last = qMin(count - 1, last + VISIBLE_ROW_PADDING);
+
+        for(int i = first; i <= last; ++i)
+        {
+            createItems(i);
+        }
+    }
+
+    m_timerAttribute.start();
+}
+
+void MusicSongsListPlayTableWidget::attributeTimeOut()
+{
+    m_attributeRows.clear();
+
+    int first = 0, last = 0;
+    if(!visibleRowRange(first, last))
+    {
+        return;
+    }
+
+    QStringList paths;
+    for(int i = first; i <= last; ++i)
+    {
+        // layout may be not finished at the time of the first pass
+        createItems(i);
+
+        const MusicSong &song = m_songs->at(i);
+        if(!song.hasAttributes() && !m_attributeRows.contains(song.path()))
+        {
+            m_attributeRows.insert(song.path(), i);
+            paths << song.path();
+        }
+    }
+
+    m_attributeThread->setSongPaths(paths);
+}
+
+void MusicSongsListPlayTableWidget::attributesChanged(const QString &path, qint64 size, qint64 addTime)
+{
+    // results of a dropped request are no longer tracked
+    if(!m_attributeRows.contains(path))
+    {
+        return;
+    }
+
+    const int row = m_attributeRows.take(path);
+    // songs may be changed since the request, apply only if row still holds the same song
+    if(m_songs && row >= 0 && row < m_songs->count() && m_songs->at(row).path() == path)
+    {
+        (*m_songs)[row].setAttributes(size, addTime);
+    }
+}
+
 void MusicSongsListPlayTableWidget::mousePressEvent(QMouseEvent *event)
 {
     MusicAbstractSongsListTableWidget::mousePressEvent(event);
@@ -645,6 +690,12 @@ void MusicSongsListPlayTableWidget::leaveEvent(QEvent *event)
     closeRenameItem();
 }
 
+void MusicSongsListPlayTableWidget::showEvent(QShowEvent *event)
+{
+    MusicAbstractSongsListTableWidget::showEvent(event);
+    updateVisibleItems();
+}
+
 void MusicSongsListPlayTableWidget::wheelEvent(QWheelEvent *event)
 {
     MusicAbstractSongsListTableWidget::wheelEvent(event);
@@ -741,9 +792,7 @@ void MusicSongsListPlayTableWidget::closeRenameItem()
     //the two if function to deal with
     if(m_renameActived)
     {
-        QHeaderView *headerView = horizontalHeader();
         (*m_songs)[m_renameItem->row()].setName(m_renameItem->text());
-        m_renameItem->setText(TTK::Widget::elidedText(font(), m_renameItem->text(), Qt::ElideRight, headerView->sectionSize(1) - 10));
 
         m_renameActived = false;
         setItemDelegateForRow(m_renameItem->row(), nullptr);
@@ -794,9 +843,12 @@ void MusicSongsListPlayTableWidget::startToDrag()
                 continue; //skip the current play item index, because the play widget just has one item
             }
 
-            QHeaderView *headerView = horizontalHeader();
-            item(i, 1)->setText(TTK::Widget::elidedText(font(), songs[i].name(), Qt::ElideRight, headerView->sectionSize(1) - 10));
-            item(i, 5)->setText(songs[i].duration());
+            // rows not created yet will read the swapped songs when they become visible
+            if(item(i, 1))
+            {
+                item(i, 1)->setText(songs[i].name());
+                item(i, 5)->setText(songs[i].duration());
+            }
         }
 
         bool state;
@@ -808,3 +860,57 @@ void MusicSongsListPlayTableWidget::startToDrag()
         }
     }
 }
+
+void MusicSongsListPlayTableWidget::createItems(int row)
+{
+    if(row < 0 || row == m_playRowIndex || row >= m_songs->count() || item(row, 1))
+    {
+        return;
+    }
+
+    const MusicSong &v = m_songs->at(row);
+
+    QTableWidgetItem *item = new QTableWidgetItem;
+    setItem(row, 0, item);
+
+                      item = new QTableWidgetItem(v.name());
+    item->setForeground(QColor(TTK::UI::Color01));
+    QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
+    setItem(row, 1, item);
+
+                      item = new QTableWidgetItem;
+    setItem(row, 2, item);
+
+                      item = new QTableWidgetItem;
+    setItem(row, 3, item);
+
+                      item = new QTableWidgetItem;
+    setItem(row, 4, item);
+
+                      item = new QTableWidgetItem(v.duration());
+    item->setForeground(QColor(TTK::UI::Color01));
+    QtItemSetTextAlignment(item, Qt::AlignLeft | Qt::AlignVCenter);
+    setItem(row, 5, item);
+}
+
+bool MusicSongsListPlayTableWidget::visibleRowRange(int &first, int &last) const
+{
+    const QRect &rect = visibleRegion().boundingRect();
+    if(!m_songs || rect.isEmpty())
+    {
+        return false;
+    }
+
+    first = rowAt(rect.top());
+    if(first < 0)
+    {
+        return false;
+    }
+
+    last = rowAt(rect.bottom());
+    if(last < 0 || last >= m_songs->count())
+    {
+        last = qMin(rowCount(), m_songs->count()) - 1;
+    }
+    return first <= last;
+}
@@ -27,6 +27,7 @@ class MusicOpenFileWidget;
 class MusicSongsListPlayWidget;
 class MusicSongsListItemInfoWidget;
 class MusicLineEditItemDelegate;
+class MusicSongAttributeThread;
 
 /*! @brief The class of the songs list play table widget.
  * @author Greedysky <greedysky@163.com>
@@ -159,6 +160,10 @@ public Q_SLOTS:
      * Music list songs sort by type.
      */
     void songListSortBy(QAction *action);
+    /*!
+     * Create items of visible rows and refresh their file attributes later.
+     */
+    void updateVisibleItems();
 
 private Q_SLOTS:
     /*!
@@ -169,6 +174,14 @@ private Q_SLOTS:
      * Hide play item information widget.
      */
     void stayTimeOut();
+    /*!
+     * Create visible items and fetch their file attributes.
+     */
+    void attributeTimeOut();
+    /*!
+     * Song file attributes fetch finished.
+     */
+    void attributesChanged(const QString &path, qint64 size, qint64 addTime);
 
 private:
     /*!
@@ -178,6 +191,7 @@ private:
     virtual void mouseMoveEvent(QMouseEvent *event) override final;
     virtual void mouseReleaseEvent(QMouseEvent *event) override final;
     virtual void leaveEvent(QEvent *event) override final;
+    virtual void showEvent(QShowEvent *event) override final;
     virtual void wheelEvent(QWheelEvent *event) override final;
     virtual void contextMenuEvent(QContextMenuEvent *event) override final;
     /*!
@@ -188,13 +202,23 @@ private:
      * Start to drag to play list.
      */
     void startToDrag();
+    /*!
+     * Create items of the given row if not created yet.
+     */
+    void createItems(int row);
+    /*!
+     * Get current visible row range.
+     */
+    bool visibleRowRange(int &first, int &last) const;
 
     QWidget *m_parent;
     int m_dragStartIndex;
     QPoint m_dragStartPoint;
     bool m_mouseMoved;
 
-    QTimer m_timerShow, m_timerStay;
+    QTimer m_timerShow, m_timerStay, m_timerAttribute;
+    QHash<QString, int> m_attributeRows;
+    MusicSongAttributeThread *m_attributeThread;
     MusicOpenFileWidget *m_openFileWidget;
     MusicSongsListItemInfoWidget *m_songsInfoWidget;
     MusicSongsListPlayWidget *m_songsPlayWidget;
@@ -20,6 +20,8 @@
 #include "musictinyuiobject.h"
 #include "musicdispatchmanager.h"
 #include "musictkplconfigmanager.h"
+#include "musictkblconfigmanager.h"
+#include "musicsongmetaindex.h"
 #include "musicinputdialog.h"
 #include "ttkversion.h"
 #include "qalgorithm/aeswrapper.h"
@@ -196,7 +198,7 @@ void MusicApplication::importSongsByOutside(const QString &path, bool play)
         return;
     }
 
-    m_songTreeWidget->importSongsByPath({path}, MUSIC_NORMAL_LIST);
+    m_songTreeWidget->importSongsByPath({path}, MUSIC_NORMAL_LIST, true);
     if(play)
     {
         playIndexBy(m_playlist->count() - 1, TTK_NORMAL_LEVEL);
@@ -1101,10 +1103,24 @@ void MusicApplication::readSystemConfigFromFile()
     //Path configuration song
     MusicSongItemList songs;
     {
-        MusicTKPLConfigManager manager;
-        if(manager.fromFile(PLAYLIST_PATH_FULL))
+        // binary playlist is preferred, unless tkpl file is changed outside
+        const QFileInfo binary(PLAYLIST_BINARY_PATH_FULL), xml(PLAYLIST_PATH_FULL);
+        if(binary.exists() && (!xml.exists() || binary.lastModified() >= xml.lastModified()))
+        {
+            MusicTKBLConfigManager manager;
+            if(manager.fromFile(PLAYLIST_BINARY_PATH_FULL))
+            {
+                manager.readBuffer(songs);
+            }
+        }
+
+        if(songs.isEmpty())
         {
-            manager.readBuffer(songs);
+            MusicTKPLConfigManager manager;
+            if(manager.fromFile(PLAYLIST_PATH_FULL))
+            {
+                manager.readBuffer(songs);
+            }
         }
     }
 
@@ -1269,6 +1285,9 @@ void MusicApplication::writeSystemConfigToFile()
     G_SETTING_PTR->setValue(MusicSettingManager::BackgroundTransparentEnable, m_topAreaWidget->backgroundTransparentEnabled());
     G_SETTING_PTR->setValue(MusicSettingManager::ShowDesktopLrc, m_rightAreaWidget->destopLrcVisible());
     manager.writeBuffer();
+    //Write song meta index, drop items of deleted or moved files first
+    G_SONGMETA_INDEX_PTR->purge();
+    G_SONGMETA_INDEX_PTR->save();
 
     {
         MusicTKPLConfigManager manager;
@@ -1279,4 +1298,15 @@ void MusicApplication::writeSystemConfigToFile()
 
         manager.writeBuffer(m_songTreeWidget->items());
     }
+
+    {
+        // write binary playlist last, so that it is newer than tkpl file
+        MusicTKBLConfigManager manager;
+        if(!manager.load(PLAYLIST_BINARY_PATH_FULL))
+        {
+            return;
+        }
+
+        manager.writeBuffer(m_songTreeWidget->items());
+    }
 }
@@ -174,6 +174,19 @@ void MusicRightAreaWidget::updateCurrentLrc(qint64 current, qint64 total, bool p
                 m_lrcForWallpaper->updateCurrentLrc(intervalTime);
             }
         }
+
+        //Keep the lrc mask on the player position, so seek or audio stall never drifts it
+        const qint64 elapsed = m_lrcAnalysis->findElapsed(current);
+        if(playState && elapsed >= 0)
+        {
+            m_lrcForInterior->setDrawLrcPosition(elapsed);
+            m_lrcForDesktop->setDrawLrcPosition(elapsed);
+
+            if(m_lrcForWallpaper)
+            {
+                m_lrcForWallpaper->setDrawLrcPosition(elapsed);
+            }
+        }
     }
 }
 
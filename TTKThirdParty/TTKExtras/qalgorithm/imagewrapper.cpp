@@ -3,6 +3,15 @@
 
 #include <qmath.h>
 #include <QPainter>
+#include <QRunnable>
+#include <QThreadPool>
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define QALGORITHM_BLUR_SSE2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define QALGORITHM_BLUR_NEON
+#  include <arm_neon.h>
+#endif
 
 namespace QAlgorithm
 {
@@ -34,121 +43,284 @@ void ImageRender::input(const QRect &region)
 }
 
 ////////////////////////////////////////////////////////////////////////
-GaussBlur::GaussBlur()
-    : ImageRender()
+static constexpr int GAUSS_BLUR_PASS_COUNT = 3;
+static constexpr int GAUSS_BLUR_PARALLEL_PIXELS = 256 * 256;
+
+/*! @brief The namespace of the gauss blur channel vector.
+ * Each pixel is kept as four int32 channel sums, one lane per channel.
+ * @author Greedysky <greedysky@163.com>
+ */
+namespace BlurVector
+{
+#if defined(QALGORITHM_BLUR_SSE2)
+typedef __m128i Sum;
+typedef __m128 Scale;
+
+static inline Sum zero() { return _mm_setzero_si128(); }
+static inline Scale scale(float value) { return _mm_set1_ps(value); }
+static inline Sum add(Sum a, Sum b) { return _mm_add_epi32(a, b); }
+static inline Sum sub(Sum a, Sum b) { return _mm_sub_epi32(a, b); }
+static inline Sum load(const int *sum) { return _mm_loadu_si128((const __m128i*)sum); }
+static inline void save(int *sum, Sum v) { _mm_storeu_si128((__m128i*)sum, v); }
+
+static inline Sum unpack(QRgb pixel)
 {
+    const __m128i z = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(pixel), z), z);
+}
 
+static inline QRgb pack(Sum v, Scale s)
+{
+    __m128i c = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(v), s));
+    c = _mm_packs_epi32(c, c);
+    c = _mm_packus_epi16(c, c);
+    return _mm_cvtsi128_si32(c);
+}
+#elif defined(QALGORITHM_BLUR_NEON)
+typedef int32x4_t Sum;
+typedef float32x4_t Scale;
+
+static inline Sum zero() { return vdupq_n_s32(0); }
+static inline Scale scale(float value) { return vdupq_n_f32(value); }
+static inline Sum add(Sum a, Sum b) { return vaddq_s32(a, b); }
+static inline Sum sub(Sum a, Sum b) { return vsubq_s32(a, b); }
+static inline Sum load(const int *sum) { return vld1q_s32(sum); }
+static inline void save(int *sum, Sum v) { vst1q_s32(sum, v); }
+
+static inline Sum unpack(QRgb pixel)
+{
+    const uint16x8_t c = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(pixel)));
+    return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(c)));
 }
 
-QPixmap GaussBlur::render(const QPixmap &pixmap, int value)
+static inline QRgb pack(Sum v, Scale s)
 {
-    TTK_D(ImageRender);
-    QImage image = pixmap.copy(d->m_rectangle).toImage();
+    const float32x4_t f = vaddq_f32(vmulq_f32(vcvtq_f32_s32(v), s), vdupq_n_f32(0.5f));
+    const uint16x4_t c = vqmovn_u32(vcvtq_u32_f32(f));
+    return vget_lane_u32(vreinterpret_u32_u8(vqmovn_u16(vcombine_u16(c, c))), 0);
+}
+#else
+struct Sum { int c[4]; };
+typedef float Scale;
+
+static inline Sum zero() { Sum v = {{0, 0, 0, 0}}; return v; }
+static inline Scale scale(float value) { return value; }
+static inline Sum add(Sum a, Sum b) { for(int i = 0; i < 4; ++i) a.c[i] += b.c[i]; return a; }
+static inline Sum sub(Sum a, Sum b) { for(int i = 0; i < 4; ++i) a.c[i] -= b.c[i]; return a; }
+static inline Sum load(const int *sum) { Sum v; memcpy(v.c, sum, sizeof(v.c)); return v; }
+static inline void save(int *sum, Sum v) { memcpy(sum, v.c, sizeof(v.c)); }
+
+static inline Sum unpack(QRgb pixel)
+{
+    Sum v = {{int(pixel & 0xff), int((pixel >> 8) & 0xff), int((pixel >> 16) & 0xff), int(pixel >> 24)}};
+    return v;
+}
 
-    const float sigma = 1.0 * value / 2.57;
-    const float deno = 1.0 / (sigma * sqrt(2.0 * M_PI));
-    const float nume = -1.0 / (2.0 * sigma * sigma);
+static inline QRgb pack(Sum v, Scale s)
+{
+    QRgb pixel = 0;
+    for(int i = 0; i < 4; ++i)
+    {
+        pixel |= QRgb(qBound(0, int(v.c[i] * s + 0.5f), 0xff)) << (i * 8);
+    }
+    return pixel;
+}
+#endif
+}
 
-    float* gaussMatrix = (float*)malloc(sizeof(float)* (value + value + 1));
-    float gaussSum = 0.0;
-    for(int i = 0, x = -value; x <= value; ++x, ++i)
+/*! @brief The class of the gauss blur box pass.
+ * Running sum box filter, O(1) per pixel for any radius, edges are clamped.
+ * @author Greedysky <greedysky@163.com>
+ */
+class GaussBlurPass : public QRunnable
+{
+public:
+    enum class Direction
+    {
+        Horizontal,     /*!< blur rows in [from, to) */
+        Vertical        /*!< blur columns in [from, to) */
+    };
+
+    GaussBlurPass(Direction direction, const QRgb *src, QRgb *dst, int width, int height, int radius, int from, int to)
+        : m_direction(direction),
+          m_src(src),
+          m_dst(dst),
+          m_width(width),
+          m_height(height),
+          m_radius(radius),
+          m_from(from),
+          m_to(to)
     {
-        float g = deno * exp(1.0 * nume * x * x);
 
-        gaussMatrix[i] = g;
-        gaussSum += g;
     }
 
-    const int len = value + value + 1;
-    for(int i = 0; i < len; ++i)
+    virtual void run() override final
     {
-        gaussMatrix[i] /= gaussSum;
+        m_direction == Direction::Horizontal ? horizontal() : vertical();
     }
 
-    const int width = image.width();
-    const int height = image.height();
-    int *pix = (int*)image.bits();
-    int *rowData = (int*)malloc(width * sizeof(int));
-    int *listData = (int*)malloc(height * sizeof(int));
-
-    for(int y = 0; y < height; ++y)
+private:
+    void horizontal() const
     {
-        memcpy(rowData, pix + y * width, sizeof(int) *width);
+        const int last = m_width - 1;
+        const BlurVector::Scale scale = BlurVector::scale(1.0f / (2 * m_radius + 1));
 
-        for(int x = 0; x < width; ++x)
+        for(int y = m_from; y < m_to; ++y)
         {
-            float r = 0, g = 0, b = 0;
-            gaussSum = 0;
+            const QRgb *src = m_src + y * m_width;
+            QRgb *dst = m_dst + y * m_width;
 
-            for(int i = -value; i <= value; ++i)
+            BlurVector::Sum sum = BlurVector::zero();
+            const BlurVector::Sum first = BlurVector::unpack(src[0]);
+            for(int i = 0; i <= m_radius; ++i)
             {
-                int k = x + i;
-
-                if(0 <= k && k <= width)
-                {
-                    int color = rowData[k];
-                    int cr = (color & 0x00ff0000) >> 16;
-                    int cg = (color & 0x0000ff00) >> 8;
-                    int cb = (color & 0x000000ff);
-
-                    r += cr * gaussMatrix[i + value];
-                    g += cg * gaussMatrix[i + value];
-                    b += cb * gaussMatrix[i + value];
-
-                    gaussSum += gaussMatrix[i + value];
-                }
+                sum = BlurVector::add(sum, first);
             }
 
-            int cr = (int)(r / gaussSum);
-            int cg = (int)(g / gaussSum);
-            int cb = (int)(b / gaussSum);
+            for(int i = 1; i <= m_radius; ++i)
+            {
+                sum = BlurVector::add(sum, BlurVector::unpack(src[qMin(i, last)]));
+            }
 
-            pix[y * width + x] = cr << 16 | cg << 8 | cb | 0xff000000;
+            for(int x = 0; x < m_width; ++x)
+            {
+                dst[x] = BlurVector::pack(sum, scale);
+                sum = BlurVector::add(sum, BlurVector::unpack(src[qMin(x + m_radius + 1, last)]));
+                sum = BlurVector::sub(sum, BlurVector::unpack(src[qMax(x - m_radius, 0)]));
+            }
         }
     }
 
-    for(int x = 0; x < width; ++x)
+    void vertical() const
     {
-        for(int y = 0; y < height; ++y)
+        // walk down the rows with one running sum per column, so memory is read row by row
+        const int last = m_height - 1;
+        const int count = m_to - m_from;
+        const BlurVector::Scale scale = BlurVector::scale(1.0f / (2 * m_radius + 1));
+
+        QVector<int> buffer(count * 4, 0);
+        int *sums = buffer.data();
+
+        for(int x = 0; x < count; ++x)
         {
-            listData[y] = pix[y * width + x];
+            BlurVector::Sum sum = BlurVector::zero();
+            const BlurVector::Sum first = BlurVector::unpack(m_src[m_from + x]);
+            for(int i = 0; i <= m_radius; ++i)
+            {
+                sum = BlurVector::add(sum, first);
+            }
+
+            for(int i = 1; i <= m_radius; ++i)
+            {
+                sum = BlurVector::add(sum, BlurVector::unpack(m_src[qMin(i, last) * m_width + m_from + x]));
+            }
+            BlurVector::save(sums + x * 4, sum);
         }
 
-        for(int y = 0; y < height; ++y)
+        for(int y = 0; y < m_height; ++y)
         {
-            float r = 0, g = 0, b = 0;
-            gaussSum = 0;
+            const QRgb *in = m_src + qMin(y + m_radius + 1, last) * m_width + m_from;
+            const QRgb *out = m_src + qMax(y - m_radius, 0) * m_width + m_from;
+            QRgb *dst = m_dst + y * m_width + m_from;
 
-            for(int j = -value; j <= value; ++j)
+            for(int x = 0; x < count; ++x)
             {
-                int k = y + j;
+                BlurVector::Sum sum = BlurVector::load(sums + x * 4);
+                dst[x] = BlurVector::pack(sum, scale);
+                sum = BlurVector::add(sum, BlurVector::unpack(in[x]));
+                sum = BlurVector::sub(sum, BlurVector::unpack(out[x]));
+                BlurVector::save(sums + x * 4, sum);
+            }
+        }
+    }
 
-                if(0 <= k && k <= height)
-                {
-                    int color = listData[k];
-                    int cr = (color & 0x00ff0000) >> 16;
-                    int cg = (color & 0x0000ff00) >> 8;
-                    int cb = (color & 0x000000ff);
+    Direction m_direction;
+    const QRgb *m_src;
+    QRgb *m_dst;
+    int m_width, m_height, m_radius;
+    int m_from, m_to;
 
-                    r += cr * gaussMatrix[j + value];
-                    g += cg * gaussMatrix[j + value];
-                    b += cb * gaussMatrix[j + value];
+};
 
-                    gaussSum += gaussMatrix[j + value];
-                }
-            }
+static void boxesForGauss(float sigma, int *radius, int n)
+{
+    // box widths whose successive convolution matches the gauss standard deviation
+    const float ideal = sqrt(12.0 * sigma * sigma / n + 1);
+    int lower = floor(ideal);
+    if(lower % 2 == 0)
+    {
+        --lower;
+    }
+
+    const int upper = lower + 2;
+    const int m = qRound((12.0 * sigma * sigma - n * lower * lower - 4.0 * n * lower - 3.0 * n) / (-4.0 * lower - 4.0));
+
+    for(int i = 0; i < n; ++i)
+    {
+        radius[i] = ((i < m ? lower : upper) - 1) / 2;
+    }
+}
+
+static void boxBlur(QThreadPool *pool, GaussBlurPass::Direction direction, const QRgb *src, QRgb *dst, int width, int height, int radius)
+{
+    const int length = direction == GaussBlurPass::Direction::Horizontal ? height : width;
+    if(!pool)
+    {
+        GaussBlurPass(direction, src, dst, width, height, radius, 0, length).run();
+        return;
+    }
+
+    const int count = pool->maxThreadCount();
+    const int step = (length + count - 1) / count;
+    for(int from = 0; from < length; from += step)
+    {
+        pool->start(new GaussBlurPass(direction, src, dst, width, height, radius, from, qMin(from + step, length)));
+    }
+    pool->waitForDone();
+}
 
-            int cr = (int)(r / gaussSum);
-            int cg = (int)(g / gaussSum);
-            int cb = (int)(b / gaussSum);
 
-            pix[y * width + x] = cr << 16 | cg << 8 | cb | 0xff000000;
+GaussBlur::GaussBlur()
+    : ImageRender()
+{
+
+}
+
+QPixmap GaussBlur::render(const QPixmap &pixmap, int value)
+{
+    TTK_D(ImageRender);
+    QImage image = pixmap.copy(d->m_rectangle).toImage().convertToFormat(QImage::Format_RGB32);
+
+    const int width = image.width();
+    const int height = image.height();
+    if(value <= 0 || width <= 0 || height <= 0)
+    {
+        return QPixmap::fromImage(image);
+    }
+
+    int radius[GAUSS_BLUR_PASS_COUNT];
+    boxesForGauss(1.0 * value / 2.57, radius, GAUSS_BLUR_PASS_COUNT);
+
+    QImage buffer(width, height, QImage::Format_RGB32);
+    QRgb *pix = (QRgb*)image.bits();
+    QRgb *temp = (QRgb*)buffer.bits();
+
+    // image rows are 32 bit aligned, so bytes per line is always width * 4 here
+    QThreadPool pool;
+    const bool parallel = width * height >= GAUSS_BLUR_PARALLEL_PIXELS && QThread::idealThreadCount() > 1;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+
+    for(int i = 0; i < GAUSS_BLUR_PASS_COUNT; ++i)
+    {
+        if(radius[i] <= 0)
+        {
+            continue;
         }
+
+        boxBlur(parallel ? &pool : nullptr, GaussBlurPass::Direction::Horizontal, pix, temp, width, height, radius[i]);
+        boxBlur(parallel ? &pool : nullptr, GaussBlurPass::Direction::Vertical, temp, pix, width, height, radius[i]);
     }
 
-    free(gaussMatrix);
-    free(rowData);
-    free(listData);
     return QPixmap::fromImage(image);
 }
 
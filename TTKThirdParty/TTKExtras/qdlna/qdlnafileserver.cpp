@@ -6,8 +6,20 @@
 
 #include <QFile>
 #include <QRegExp>
+#include <QFileInfo>
 #include <QNetworkInterface>
 
+static constexpr qint64 STREAM_CHUNK_SIZE = 64 * 1024;
+
+/*! @brief The class of the dlna file stream.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct QDlnaFileStream
+{
+    QFile *m_file;
+    qint64 m_remain;
+};
+
 /*! @brief The class of the dlna file server private.
  * @author Greedysky <greedysky@163.com>
  */
@@ -17,8 +29,14 @@ public:
     QDlnaFileServerPrivate();
     ~QDlnaFileServerPrivate();
 
+    void closeStream(QHttpResponse *response);
+
+    static QString mimeType(const QString &path);
+    static bool parseRange(const QString &value, qint64 size, qint64 &start, qint64 &end);
+
     QString m_prefix;
     QHttpServer *m_server;
+    QHash<QHttpResponse*, QDlnaFileStream> m_streams;
 
 };
 
@@ -30,10 +48,82 @@ QDlnaFileServerPrivate::QDlnaFileServerPrivate()
 
 QDlnaFileServerPrivate::~QDlnaFileServerPrivate()
 {
+    for(const QDlnaFileStream &stream : qAsConst(m_streams))
+    {
+        delete stream.m_file;
+    }
+
     m_server->close();
     delete m_server;
 }
 
+void QDlnaFileServerPrivate::closeStream(QHttpResponse *response)
+{
+    const auto it = m_streams.find(response);
+    if(it == m_streams.end())
+    {
+        return;
+    }
+
+    delete it->m_file;
+    m_streams.erase(it);
+}
+
+QString QDlnaFileServerPrivate::mimeType(const QString &path)
+{
+    static QHash<QString, QString> types;
+    if(types.isEmpty())
+    {
+        types.insert("mp3", "audio/mpeg");
+        types.insert("flac", "audio/flac");
+        types.insert("ape", "audio/x-ape");
+        types.insert("wav", "audio/wav");
+        types.insert("ogg", "audio/ogg");
+        types.insert("oga", "audio/ogg");
+        types.insert("opus", "audio/ogg");
+        types.insert("m4a", "audio/mp4");
+        types.insert("mp4", "audio/mp4");
+        types.insert("aac", "audio/aac");
+        types.insert("wma", "audio/x-ms-wma");
+        types.insert("aif", "audio/aiff");
+        types.insert("aiff", "audio/aiff");
+        types.insert("dsf", "audio/x-dsf");
+        types.insert("dff", "audio/x-dff");
+        types.insert("wv", "audio/x-wavpack");
+        types.insert("mpc", "audio/x-musepack");
+    }
+    return types.value(QFileInfo(path).suffix().toLower(), "application/octet-stream");
+}
+
+bool QDlnaFileServerPrivate::parseRange(const QString &value, qint64 size, qint64 &start, qint64 &end)
+{
+    // only a single range is served, e.g. bytes=0-499, bytes=500- or bytes=-500
+    const QRegExp regx("^\\s*bytes\\s*=\\s*(\\d*)\\s*-\\s*(\\d*)\\s*$");
+    if(regx.indexIn(value) == -1)
+    {
+        return false;
+    }
+
+    const QString &first = regx.cap(1);
+    const QString &last = regx.cap(2);
+    if(first.isEmpty())
+    {
+        if(last.isEmpty())
+        {
+            return false;
+        }
+
+        start = qMax(0LL, size - last.toLongLong());
+        end = size - 1;
+    }
+    else
+    {
+        start = first.toLongLong();
+        end = last.isEmpty() ? size - 1 : qMin(last.toLongLong(), size - 1);
+    }
+    return start <= end && start < size;
+}
+
 
 
 QDlnaFileServer::QDlnaFileServer(QObject *parent)
@@ -82,27 +172,106 @@ void QDlnaFileServer::handleRequest(QHttpRequest *request, QHttpResponse *respon
     }
 
     const QRegExp regx("^/music/(.*)$");
-    if(regx.indexIn(request->path()) != -1)
+    if(regx.indexIn(request->path()) == -1 || regx.cap(1).contains(".."))
+    {
+        response->writeHead(403);
+        response->end("You aren't allowed here");
+        return;
+    }
+
+    const QString &name = regx.cap(1);
+    QFile *file = new QFile(d->m_prefix + TTK_SEPARATOR + name);
+    if(!file->open(QIODevice::ReadOnly))
     {
-        response->setHeader("Content-Type", "audio/mp3");
+        delete file;
+        response->writeHead(404);
+        response->end("Resource not found");
+        return;
+    }
 
-        const QString &name = regx.cap(1);
-        QFile file(d->m_prefix + TTK_SEPARATOR + name);
-        if(file.open(QIODevice::ReadOnly))
-        {
-            response->writeHead(200);
-            response->end(file.readAll());
-            file.close();
-        }
-        else
+    const qint64 size = file->size();
+    qint64 start = 0, end = size - 1;
+    int status = QHttpResponse::STATUS_OK;
+
+    const QString &range = request->header("range");
+    if(!range.isEmpty())
+    {
+        if(!QDlnaFileServerPrivate::parseRange(range, size, start, end))
         {
-            response->writeHead(404);
-            response->end("Resource not found");
+            delete file;
+            response->setHeader("Content-Range", QString("bytes */%1").arg(size));
+            response->writeHead(QHttpResponse::STATUS_REQUESTED_RANGE_NOT_SATISFIABLE);
+            response->end();
+            return;
         }
+
+        status = QHttpResponse::STATUS_PARTIAL_CONTENT;
+        response->setHeader("Content-Range", QString("bytes %1-%2/%3").arg(start).arg(end).arg(size));
+    }
+
+    const qint64 length = size > 0 ? end - start + 1 : 0;
+    response->setHeader("Content-Type", QDlnaFileServerPrivate::mimeType(name));
+    response->setHeader("Content-Length", QString::number(length));
+    response->setHeader("Accept-Ranges", "bytes");
+    response->setHeader("transferMode.dlna.org", "Streaming");
+    response->writeHead(status);
+
+    if(request->method() == QHttpRequest::HTTP_HEAD || length == 0 || !file->seek(start))
+    {
+        delete file;
+        response->end();
+        return;
+    }
+
+    // the body is sent chunk by chunk, next chunk goes out once the socket drained the previous one
+    QDlnaFileStream stream;
+    stream.m_file = file;
+    stream.m_remain = length;
+    d->m_streams.insert(response, stream);
+
+    connect(response, SIGNAL(allBytesWritten()), SLOT(writeChunk()));
+    connect(response, SIGNAL(done()), SLOT(responseDone()));
+    writeChunk(response);
+}
+
+void QDlnaFileServer::writeChunk()
+{
+    QHttpResponse *response = TTKObjectCast(QHttpResponse*, sender());
+    if(response)
+    {
+        writeChunk(response);
+    }
+}
+
+void QDlnaFileServer::responseDone()
+{
+    TTK_D(QDlnaFileServer);
+    d->closeStream(TTKObjectCast(QHttpResponse*, sender()));
+}
+
+void QDlnaFileServer::writeChunk(QHttpResponse *response)
+{
+    TTK_D(QDlnaFileServer);
+    const auto it = d->m_streams.find(response);
+    if(it == d->m_streams.end())
+    {
+        return;
+    }
+
+    const QByteArray &data = it->m_file->read(qMin(it->m_remain, STREAM_CHUNK_SIZE));
+    if(data.isEmpty())
+    {
+        response->end();
+        return;
+    }
+
+    it->m_remain -= data.length();
+    if(it->m_remain > 0)
+    {
+        response->write(data);
     }
     else
     {
-        response->writeHead(403);
-        response->end("You aren't allowed here");
+        response->end(data);
     }
 }
@@ -42,6 +42,11 @@ public:
 
 private Q_SLOTS:
     void handleRequest(QHttpRequest *request, QHttpResponse *response);
+    void writeChunk();
+    void responseDone();
+
+private:
+    void writeChunk(QHttpResponse *response);
 
 private:
     TTK_DECLARE_PRIVATE(QDlnaFileServer)
@@ -1,7 +1,123 @@
 #include "qsyncuploaddata.h"
 #include "qsyncdatainterface_p.h"
 
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QtXml/QDomDocument>
+
+static constexpr qint64 UPLOAD_PART_SIZE = 4 * 1024 * 1024;
+static constexpr int UPLOAD_RETRY_COUNT = 3;
+static constexpr quint32 UPLOAD_RESUME_MAGIC = 0x544B5552;
+static constexpr qint32 UPLOAD_RESUME_VERSION = 1;
+
+static constexpr const char *UPLOAD_TIME = "time";
+static constexpr const char *UPLOAD_STEP = "step";
+
+/*! @brief The class of the sync cloud upload part.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct QSyncUploadPart
+{
+    qint64 m_offset;
+    qint64 m_size;
+    QString m_etag;
+};
+
+/*! @brief The class of the sync cloud upload task.
+ * @author Greedysky <greedysky@163.com>
+ */
+struct QSyncUploadTask
+{
+    enum class Step
+    {
+        Single,         /*!< put the whole file */
+        Initiate,       /*!< initiate multipart upload */
+        Part,           /*!< upload one part */
+        Complete        /*!< complete multipart upload */
+    };
+
+    QString m_time;
+    QString m_bucket;
+    QString m_fileName;
+    QString m_filePath;
+    qint64 m_size;
+    qint64 m_lastModified;
+    QString m_uploadId;
+    QList<QSyncUploadPart> m_parts;
+    int m_part;
+    int m_retry;
+
+    QSyncUploadTask()
+        : m_size(0),
+          m_lastModified(0),
+          m_part(-1),
+          m_retry(0)
+    {
+
+    }
+
+    inline bool isMultipart() const
+    {
+        return !m_parts.isEmpty();
+    }
+
+    inline bool isSameFile(const QSyncUploadTask &other) const
+    {
+        return m_bucket == other.m_bucket && m_fileName == other.m_fileName && m_size == other.m_size && m_lastModified == other.m_lastModified;
+    }
+
+    inline int nextPart() const
+    {
+        for(int i = 0; i < m_parts.count(); ++i)
+        {
+            if(m_parts[i].m_etag.isEmpty())
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    inline qint64 uploadedSize() const
+    {
+        qint64 size = 0;
+        for(const QSyncUploadPart &part : qAsConst(m_parts))
+        {
+            if(!part.m_etag.isEmpty())
+            {
+                size += part.m_size;
+            }
+        }
+        return size;
+    }
+};
+
+static QDataStream& operator<<(QDataStream &stream, const QSyncUploadPart &part)
+{
+    stream << part.m_offset << part.m_size << part.m_etag;
+    return stream;
+}
+
+static QDataStream& operator>>(QDataStream &stream, QSyncUploadPart &part)
+{
+    stream >> part.m_offset >> part.m_size >> part.m_etag;
+    return stream;
+}
+
+static QDataStream& operator<<(QDataStream &stream, const QSyncUploadTask &task)
+{
+    stream << task.m_bucket << task.m_fileName << task.m_filePath << task.m_size << task.m_lastModified << task.m_uploadId << task.m_parts;
+    return stream;
+}
+
+static QDataStream& operator>>(QDataStream &stream, QSyncUploadTask &task)
+{
+    stream >> task.m_bucket >> task.m_fileName >> task.m_filePath >> task.m_size >> task.m_lastModified >> task.m_uploadId >> task.m_parts;
+    return stream;
+}
 
 /*! @brief The class of the sync cloud upload data private.
  * @author Greedysky <greedysky@163.com>
@@ -10,11 +126,105 @@ class QSyncUploadDataPrivate : public QSyncDataInterfacePrivate
 {
 public:
     QSyncUploadDataPrivate()
-        : QSyncDataInterfacePrivate()
+        : QSyncDataInterfacePrivate(),
+          m_partSize(UPLOAD_PART_SIZE),
+          m_retryCount(UPLOAD_RETRY_COUNT)
     {
     }
 
-    QString m_uploadTime;
+    QNetworkRequest createRequest(const QString &method, const QSyncUploadTask &task, const QString &subResource) const
+    {
+        const QString &url = TTK_SEPARATOR + task.m_fileName + subResource;
+        const QString &resource = TTK_SEPARATOR + task.m_bucket + url;
+        const QString &host = task.m_bucket + TTK_DOT + QSyncConfig::HOST;
+
+        TTKStringMap headers;
+        headers.insert("Host", host);
+        headers.insert("Date", QSyncUtils::GMT());
+        headers.insert("Content-Type", "charset=utf-8");
+
+        insertAuthorization(method, headers, resource);
+
+        QNetworkRequest request;
+        request.setUrl(HTTP_PROTOCOL + host + url);
+
+        for(auto it = headers.constBegin(); it != headers.constEnd(); ++it)
+        {
+            request.setRawHeader(it.key().toUtf8(), it.value().toUtf8());
+        }
+        return request;
+    }
+
+    void loadResumes()
+    {
+        QFile file(m_resumePath);
+        if(m_resumePath.isEmpty() || !file.open(QIODevice::ReadOnly))
+        {
+            return;
+        }
+
+        quint32 magic = 0;
+        qint32 version = 0;
+        QMap<QString, QSyncUploadTask> resumes;
+
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_4_8);
+        stream >> magic >> version;
+
+        if(magic == UPLOAD_RESUME_MAGIC && version == UPLOAD_RESUME_VERSION)
+        {
+            stream >> resumes;
+            if(stream.status() == QDataStream::Ok)
+            {
+                m_resumes = resumes;
+            }
+        }
+        file.close();
+    }
+
+    void saveResumes() const
+    {
+        if(m_resumePath.isEmpty())
+        {
+            return;
+        }
+
+        // multipart uploads in flight are saved too, so a restart can resume them
+        QMap<QString, QSyncUploadTask> resumes(m_resumes);
+        for(const QSyncUploadTask &task : qAsConst(m_tasks))
+        {
+            if(task.isMultipart() && !task.m_uploadId.isEmpty())
+            {
+                resumes.insert(task.m_filePath, task);
+            }
+        }
+
+        if(resumes.isEmpty())
+        {
+            QFile::remove(m_resumePath);
+            return;
+        }
+
+        QDir().mkpath(QFileInfo(m_resumePath).absolutePath());
+
+        QFile file(m_resumePath);
+        if(!file.open(QIODevice::WriteOnly))
+        {
+            TTK_ERROR_STREAM("Save sync upload resume file error" << file.fileName());
+            return;
+        }
+
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_4_8);
+        stream << UPLOAD_RESUME_MAGIC << UPLOAD_RESUME_VERSION << resumes;
+        file.close();
+    }
+
+    qint64 m_partSize;
+    int m_retryCount;
+    QString m_resumePath;
+    QMap<QString, QSyncUploadTask> m_tasks;
+    QMap<QString, QSyncUploadTask> m_resumes;
 };
 
 
@@ -24,73 +234,253 @@ QSyncUploadData::QSyncUploadData(QNetworkAccessManager *networkManager, QObject
 {
     TTK_D(QSyncUploadData);
     d->m_manager = networkManager;
+
+    if(parent && parent->metaObject()->indexOfSlot("uploadProgress(QString,qint64,qint64)") != -1)
+    {
+        connect(this, SIGNAL(uploadProgressChanged(QString,qint64,qint64)), parent, SLOT(uploadProgress(QString,qint64,qint64)));
+    }
 }
 
 void QSyncUploadData::request(const QString &time, const QString &bucket, const QString &fileName, const QString &filePath)
 {
     TTK_D(QSyncUploadData);
-    d->m_uploadTime = time;
+    const QFileInfo fin(filePath);
 
-    const QString &method = "PUT";
-    const QString &url = TTK_SEPARATOR + fileName;
-    const QString &resource = TTK_SEPARATOR + bucket + url;
-    const QString &host = bucket + TTK_DOT + QSyncConfig::HOST;
+    QSyncUploadTask task;
+    task.m_time = time;
+    task.m_bucket = bucket;
+    task.m_fileName = fileName;
+    task.m_filePath = filePath;
+    task.m_size = fin.size();
+    task.m_lastModified = fin.lastModified().toMSecsSinceEpoch();
 
-    TTKStringMap headers;
-    headers.insert("Host", host);
-    headers.insert("Date", QSyncUtils::GMT());
-    headers.insert("Content-Type", "charset=utf-8");
+    if(task.m_size > d->m_partSize)
+    {
+        // resume the parts uploaded before, if the file has not been changed
+        const QSyncUploadTask &resume = d->m_resumes.take(filePath);
+        if(!resume.m_uploadId.isEmpty() && task.isSameFile(resume))
+        {
+            task.m_uploadId = resume.m_uploadId;
+            task.m_parts = resume.m_parts;
+        }
+        else
+        {
+            for(qint64 offset = 0; offset < task.m_size; offset += d->m_partSize)
+            {
+                QSyncUploadPart part;
+                part.m_offset = offset;
+                part.m_size = qMin(d->m_partSize, task.m_size - offset);
+                task.m_parts << part;
+            }
+        }
+    }
 
-    d->insertAuthorization(method, headers, resource);
+    d->m_tasks.insert(time, task);
+    startToUpload(time);
+}
 
-    QNetworkRequest request;
-    request.setUrl(HTTP_PROTOCOL + host + url);
+void QSyncUploadData::setResumeFilePath(const QString &path)
+{
+    TTK_D(QSyncUploadData);
+    d->m_resumePath = path;
+    d->loadResumes();
+}
+
+void QSyncUploadData::setPartSize(qint64 size)
+{
+    TTK_D(QSyncUploadData);
+    // the minimum part size of multipart upload is 100KB
+    d->m_partSize = qMax(size, 100 * 1024LL);
+}
+
+void QSyncUploadData::setRetryCount(int count)
+{
+    TTK_D(QSyncUploadData);
+    d->m_retryCount = qMax(0, count);
+}
 
-    for(auto it = headers.constBegin(); it != headers.constEnd(); ++it)
+void QSyncUploadData::receiveDataFromServer()
+{
+    TTK_D(QSyncUploadData);
+    QNetworkReply *reply = TTKObjectCast(QNetworkReply*, sender());
+    if(!reply)
     {
-        request.setRawHeader(it.key().toUtf8(), it.value().toUtf8());
+        return;
     }
 
-    QFile file(filePath);
-    file.open(QIODevice::ReadOnly);
-    QByteArray fileData = file.readAll();
-    file.close();
+    reply->deleteLater();
 
-    QNetworkReply *reply = d->m_manager->put(request, fileData);
-    connect(reply, SIGNAL(finished()), SLOT(receiveDataFromServer()));
-    QtNetworkErrorConnect(reply, this, replyError, TTK_SLOT);
+    const QString &time = reply->property(UPLOAD_TIME).toString();
+    if(!d->m_tasks.contains(time))
+    {
+        return;
+    }
 
-    if(parent()->metaObject()->indexOfSlot("uploadProgress(QString,qint64,qint64)") != -1)
+    QSyncUploadTask &task = d->m_tasks[time];
+    if(reply->error() != QNetworkReply::NoError)
     {
-        connect(reply, SIGNAL(uploadProgress(qint64,qint64)), SLOT(uploadProgress(qint64,qint64)));
-        connect(this, SIGNAL(uploadProgressChanged(QString,qint64,qint64)), parent(), SLOT(uploadProgress(QString,qint64,qint64)));
+        if(task.m_retry++ < d->m_retryCount)
+        {
+            TTK_WARN_STREAM("Sync upload request failed, retry" << task.m_retry << task.m_fileName);
+            startToUpload(time);
+        }
+        else
+        {
+            uploadFinished(time, false);
+        }
+        return;
+    }
+
+    task.m_retry = 0;
+    switch(TTKStaticCast(QSyncUploadTask::Step, reply->property(UPLOAD_STEP).toInt()))
+    {
+        case QSyncUploadTask::Step::Single:
+        case QSyncUploadTask::Step::Complete:
+        {
+            uploadFinished(time, true);
+            break;
+        }
+        case QSyncUploadTask::Step::Initiate:
+        {
+            QDomDocument docment;
+            if(docment.setContent(reply->readAll()))
+            {
+                task.m_uploadId = docment.elementsByTagName("UploadId").item(0).toElement().text();
+            }
+
+            if(task.m_uploadId.isEmpty())
+            {
+                uploadFinished(time, false);
+            }
+            else
+            {
+                d->saveResumes();
+                startToUpload(time);
+            }
+            break;
+        }
+        case QSyncUploadTask::Step::Part:
+        {
+            const QString &etag = reply->rawHeader("ETag");
+            if(task.m_part < 0 || task.m_part >= task.m_parts.count() || etag.isEmpty())
+            {
+                uploadFinished(time, false);
+            }
+            else
+            {
+                task.m_parts[task.m_part].m_etag = etag;
+                d->saveResumes();
+                startToUpload(time);
+            }
+            break;
+        }
+        default: break;
     }
 }
 
-void QSyncUploadData::receiveDataFromServer()
+void QSyncUploadData::uploadProgress(qint64 percent, qint64 total)
 {
+    Q_UNUSED(total);
     TTK_D(QSyncUploadData);
     QNetworkReply *reply = TTKObjectCast(QNetworkReply*, sender());
-    if(reply)
+    if(!reply)
+    {
+        return;
+    }
+
+    const QString &time = reply->property(UPLOAD_TIME).toString();
+    const auto it = d->m_tasks.constFind(time);
+    if(it == d->m_tasks.constEnd())
+    {
+        return;
+    }
+
+    Q_EMIT uploadProgressChanged(time, it->uploadedSize() + percent, it->m_size);
+}
+
+void QSyncUploadData::startToUpload(const QString &time)
+{
+    TTK_D(QSyncUploadData);
+    QSyncUploadTask &task = d->m_tasks[time];
+
+    QNetworkReply *reply = nullptr;
+    QSyncUploadTask::Step step = QSyncUploadTask::Step::Single;
+
+    if(!task.isMultipart())
     {
-        if(reply->error() == QNetworkReply::NoError)
+        // stream the file from disk instead of loading it into memory
+        QFile *file = new QFile(task.m_filePath);
+        if(!file->open(QIODevice::ReadOnly))
         {
-            Q_EMIT uploadFileFinished(d->m_uploadTime);
+            delete file;
+            uploadFinished(time, false);
+            return;
         }
-        else
+
+        reply = d->m_manager->put(d->createRequest("PUT", task, {}), file);
+        file->setParent(reply);
+    }
+    else if(task.m_uploadId.isEmpty())
+    {
+        step = QSyncUploadTask::Step::Initiate;
+        reply = d->m_manager->post(d->createRequest("POST", task, "?uploads"), QByteArray());
+    }
+    else if((task.m_part = task.nextPart()) != -1)
+    {
+        const QSyncUploadPart &part = task.m_parts[task.m_part];
+
+        QFile file(task.m_filePath);
+        if(!file.open(QIODevice::ReadOnly) || !file.seek(part.m_offset))
         {
-            Q_EMIT uploadFileFinished(TTK_NAN_STR);
+            uploadFinished(time, false);
+            return;
         }
-        reply->deleteLater();
+
+        // only one part of the file is kept in memory at a time
+        const QByteArray &data = file.read(part.m_size);
+        file.close();
+
+        step = QSyncUploadTask::Step::Part;
+        reply = d->m_manager->put(d->createRequest("PUT", task, QString("?partNumber=%1&uploadId=%2").arg(task.m_part + 1).arg(task.m_uploadId)), data);
     }
     else
     {
-        Q_EMIT uploadFileFinished(TTK_NAN_STR);
+        QString body = "<CompleteMultipartUpload>";
+        for(int i = 0; i < task.m_parts.count(); ++i)
+        {
+            body += QString("<Part><PartNumber>%1</PartNumber><ETag>%2</ETag></Part>").arg(i + 1).arg(task.m_parts[i].m_etag);
+        }
+        body += "</CompleteMultipartUpload>";
+
+        step = QSyncUploadTask::Step::Complete;
+        reply = d->m_manager->post(d->createRequest("POST", task, "?uploadId=" + task.m_uploadId), body.toUtf8());
     }
+
+    reply->setProperty(UPLOAD_TIME, time);
+    reply->setProperty(UPLOAD_STEP, TTKStaticCast(int, step));
+
+    connect(reply, SIGNAL(finished()), SLOT(receiveDataFromServer()));
+    connect(reply, SIGNAL(uploadProgress(qint64,qint64)), SLOT(uploadProgress(qint64,qint64)));
+    QtNetworkErrorConnect(reply, this, replyError, TTK_SLOT);
 }
 
-void QSyncUploadData::uploadProgress(qint64 percent, qint64 total)
+void QSyncUploadData::uploadFinished(const QString &time, bool state)
 {
     TTK_D(QSyncUploadData);
-    Q_EMIT uploadProgressChanged(d->m_uploadTime, percent, total);
+    const QSyncUploadTask &task = d->m_tasks.take(time);
+
+    if(state)
+    {
+        d->saveResumes();
+        Q_EMIT uploadFileFinished(time);
+        return;
+    }
+
+    if(task.isMultipart() && !task.m_uploadId.isEmpty())
+    {
+        // keep the uploaded parts, upload the same file again will resume from here
+        d->m_resumes.insert(task.m_filePath, task);
+        d->saveResumes();
+    }
+    Q_EMIT uploadFileFailed(time);
 }
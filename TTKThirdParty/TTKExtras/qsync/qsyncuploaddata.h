@@ -22,6 +22,8 @@
 #include "qsyncdatainterface.h"
 
 /*! @brief The class of the sync cloud upload data.
+ * Small files are streamed in one request, large files are uploaded by multipart
+ * and the part state is kept, so that a failed or interrupted upload can be resumed later.
  * @author Greedysky <greedysky@163.com>
  */
 class TTK_MODULE_EXPORT QSyncUploadData : public QSyncDataInterface
@@ -38,11 +40,28 @@ public:
      */
     void request(const QString &time, const QString &bucket, const QString &fileName, const QString &filePath);
 
+    /*!
+     * Set multipart part size, default is 4MB.
+     */
+    void setPartSize(qint64 size);
+    /*!
+     * Set retry count of each request, default is 3.
+     */
+    void setRetryCount(int count);
+    /*!
+     * Set multipart resume state file path, state is loaded from and saved to it.
+     */
+    void setResumeFilePath(const QString &path);
+
 Q_SIGNALS:
     /*!
      * Uplaod file finshed.
      */
     void uploadFileFinished(const QString &time);
+    /*!
+     * Uplaod file failed.
+     */
+    void uploadFileFailed(const QString &time);
     /*!
      * Show upload progress.
      */
@@ -58,6 +77,16 @@ private Q_SLOTS:
      */
     void uploadProgress(qint64 percent, qint64 total);
 
+private:
+    /*!
+     * Start next request of the upload task.
+     */
+    void startToUpload(const QString &time);
+    /*!
+     * Upload task finished.
+     */
+    void uploadFinished(const QString &time, bool state);
+
 };
 
 #endif // QSYNCUPLOADDATA_H